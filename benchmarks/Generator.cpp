@@ -0,0 +1,115 @@
+#include "Generator.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+string instance_params_t::name() const
+{
+    ostringstream out;
+    out << "s" << _stations << "-d" << _edge_density << "-c" << _schools
+        << "-p" << _passengers << "-b" << _capacity << "-seed" << _seed;
+    return out.str();
+}
+
+vector<Edge> generate_map( const instance_params_t& params )
+{
+    mt19937 rng { params._seed };
+    uniform_int_distribution<uint> cost { 1, params._max_cost };
+    bernoulli_distribution chord { params._edge_density };
+
+    vector<Edge> edges;
+    uint n = params._stations;
+    for ( uint i=1; i<=n; ++i ) {
+        for ( uint j=i+1; j<=n; ++j ) {
+            bool ring = (j == i + 1) || (i == 1 && j == n);
+            if ( ring || chord(rng) ) {
+                uint c = cost(rng);
+                edges.push_back( Edge(i, j, c) );
+                edges.push_back( Edge(j, i, c) );
+            }
+        }
+    }
+    return edges;
+}
+
+vector<Edge> generate_grid_map( const instance_params_t& params, uint columns )
+{
+    mt19937 rng { params._seed };
+    uniform_int_distribution<uint> cost { 1, params._max_cost };
+
+    vector<Edge> edges;
+    uint n = params._stations;
+    for ( uint i=1; i<=n; ++i ) {
+        uint right = i + 1, below = i + columns;
+        if ( i % columns != 0 && right <= n ) {
+            edges.push_back( Edge(i, right, cost(rng)) );
+            edges.push_back( Edge(right, i, cost(rng)) );
+        }
+        if ( below <= n ) {
+            edges.push_back( Edge(i, below, cost(rng)) );
+            edges.push_back( Edge(below, i, cost(rng)) );
+        }
+    }
+    return edges;
+}
+
+string generate_instance( const instance_params_t& params )
+{
+    uint n = params._stations;
+    vector< vector<string> > matrix( n, vector<string>(n, "--") );
+    for ( const Edge& edge : generate_map(params) )
+        matrix[edge.src-1][edge.dest-1] = to_string(edge.cost);
+
+    // Keep the seeds of the map and of the passengers apart, so 
+    // changing the passengers leaves the map alone.
+    mt19937 rng { params._seed * 7919u + 1 };
+
+    ostringstream out;
+    out << "  ";
+    for ( uint i=1; i<=n; ++i )
+        out << " P" << i;
+    out << "\n";
+    for ( uint i=1; i<=n; ++i ) {
+        out << "P" << i;
+        for ( uint j=1; j<=n; ++j )
+            out << " " << matrix[i-1][j-1];
+        out << "\n";
+    }
+
+    // Schools at distinct stations other than the bus origin when possible.
+    vector<uint> candidates;
+    for ( uint i=2; i<=n; ++i )
+        candidates.push_back(i);
+    if ( candidates.empty() )
+        candidates.push_back(1);
+    shuffle( candidates.begin(), candidates.end(), rng );
+    uint schools = max( 1u, params._schools );
+    for ( uint c=1; c<=schools; ++c ) {
+        out << (c == 1 ? "" : "; ") << "C" << c << ": P" << candidates[(c-1) % candidates.size()];
+    }
+    out << "\n";
+
+    // Waiting passengers grouped by station and school.
+    uniform_int_distribution<uint> station { 1, n };
+    uniform_int_distribution<uint> school { 1, schools };
+    map< uint, map<uint, uint> > waiting;
+    for ( uint p=0; p < max(1u, params._passengers); ++p )
+        ++waiting[station(rng)][school(rng)];
+
+    bool first_station = true;
+    for ( auto& at_station : waiting ) {
+        out << (first_station ? "" : "; ") << "P" << at_station.first << ": ";
+        first_station = false;
+        bool first_group = true;
+        for ( auto& group : at_station.second ) {
+            out << (first_group ? "" : ", ") << group.second << " C" << group.first;
+            first_group = false;
+        }
+    }
+    out << "\n";
+    out << "B: P1 " << params._capacity << "\n";
+    return out.str();
+}
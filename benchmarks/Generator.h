@@ -0,0 +1,52 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <string>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+    Parameters of a synthetic problem instance.
+*/
+typedef struct instance_params_t
+{
+    uint _stations      = 9;
+    /* Probability of an edge between two stations, on top of the 
+       ring that keeps every station reachable. */
+    double _edge_density = 0.2;
+    uint _schools       = 1;
+    uint _passengers    = 2;
+    uint _capacity      = 5;
+    uint _seed          = 1;
+    uint _max_cost      = 20;
+
+    /* Short name for CSV files, e.g. "s9-d0.2-c1-p2-b5-seed1". */
+    string name() const;
+
+} instance_params_t;
+
+/**
+    Undirected random map: a ring through every station plus 
+    random chords, with costs in [1, max_cost]. Every edge is 
+    returned in both directions.
+*/
+vector<Edge> generate_map( const instance_params_t& params );
+
+/**
+    Road-like random map for sizes 'generate_map' cannot reach,
+    as it draws every pair of stations: a grid 'columns' wide
+    where every station joins its right and lower neighbours,
+    with an independent cost in [1, max_cost] each way.
+*/
+vector<Edge> generate_grid_map( const instance_params_t& params, uint columns );
+
+/**
+    A whole problem in the '.probl' text format. Schools are 
+    spread over distinct stations, passengers wait at random 
+    stations and go to random schools, the bus starts at P1.
+*/
+string generate_instance( const instance_params_t& params );
+
+#endif
@@ -0,0 +1,82 @@
+#include "PerfCounters.h"
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+int open_counter( uint32_t type, uint64_t config )
+{
+    perf_event_attr attr;
+    memset( &attr, 0, sizeof(attr) );
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>( syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 ) );
+}
+
+} // namespace
+
+PerfCounters::PerfCounters()
+{
+    _fd[CYCLES] = open_counter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES );
+    _fd[INSTRUCTIONS] = open_counter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS );
+    _fd[CACHE_REFERENCES] = open_counter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES );
+    _fd[CACHE_MISSES] = open_counter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES );
+    _fd[L1D_READ_MISSES] = open_counter( PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) );
+}
+
+PerfCounters::~PerfCounters()
+{
+    for ( int fd : _fd )
+        if ( fd >= 0 )
+            close( fd );
+}
+
+void PerfCounters::start()
+{
+    for ( int fd : _fd ) {
+        if ( fd < 0 )
+            continue;
+        ioctl( fd, PERF_EVENT_IOC_RESET, 0 );
+        ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+    }
+}
+
+void PerfCounters::stop()
+{
+    for ( int i=0; i<COUNTERS; ++i ) {
+        _value[i] = 0;
+        if ( _fd[i] < 0 )
+            continue;
+        ioctl( _fd[i], PERF_EVENT_IOC_DISABLE, 0 );
+
+        // Value, then the time enabled and the time actually counted.
+        uint64_t read_values[3] = {};
+        if ( read( _fd[i], read_values, sizeof(read_values) ) != sizeof(read_values) || read_values[2] == 0 )
+            continue;
+        _value[i] = static_cast<uint64_t>( static_cast<double>(read_values[0])
+            * read_values[1] / read_values[2] );
+    }
+}
+
+string PerfCounters::name( counter_t counter )
+{
+    switch ( counter ) {
+        case CYCLES:            return "cycles";
+        case INSTRUCTIONS:      return "instructions";
+        case CACHE_REFERENCES:  return "cache_references";
+        case CACHE_MISSES:      return "cache_misses";
+        case L1D_READ_MISSES:   return "l1d_read_misses";
+        default:                return "";
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/**
+    Hardware counters of the calling thread, read through Linux
+    perf_event_open, as 'perf stat' would: cycles, instructions,
+    last level cache references and misses, and L1 data cache
+    read misses. User space only, so perf_event_paranoid up to 2
+    allows them.
+
+    A counter the kernel or the machine does not provide, as in
+    most virtual machines, is left unavailable and reads 0; the
+    others still count.
+*/
+class PerfCounters
+{
+public:
+    enum counter_t { CYCLES, INSTRUCTIONS, CACHE_REFERENCES, CACHE_MISSES, L1D_READ_MISSES, COUNTERS };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters( PerfCounters const& ) = delete;
+    PerfCounters& operator=( PerfCounters const& ) = delete;
+
+    /* Reset and start every available counter. */
+    void start();
+
+    /* Stop them and read their values. */
+    void stop();
+
+    bool available( counter_t counter ) const { return _fd[counter] >= 0; }
+
+    /* Value at the last stop, scaled up if the kernel multiplexed
+       the counter, or 0 if unavailable. */
+    uint64_t value( counter_t counter ) const { return _value[counter]; }
+
+    static string name( counter_t counter );
+
+private:
+    int _fd[COUNTERS];
+    uint64_t _value[COUNTERS] = {};
+};
+
+#endif
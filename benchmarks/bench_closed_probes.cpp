@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ClosedSet.h"
+#include "Options.h"
+
+using namespace std;
+
+/**
+    Closed list probe benchmark.
+
+    For every table size, fills an ClosedSet with random IDs and
+    looks random IDs up, half of them stored, as the successors of
+    expansions: in groups of 'successors' IDs. Reports lookups per
+    second one at a time with 'lookup' and per group with
+    'lookup_batch', which prefetches the slots of the group before
+    reading them. The gap grows once the table outgrows the last
+    level cache, so pick sizes on both sides of it.
+
+    Usage: bench-closed-probes [--ids=1000000,64000000]
+                               [--successors=8,16,64] [--lookups=20000000]
+                               [--seed=1] [--csv=<file>]
+*/
+
+int main( int argc, char* argv[] )
+{
+    size_t lookups = stoul(get_option(argc, argv, "lookups", "20000000"));
+    uint seed = stoul(get_option(argc, argv, "seed", "1"));
+    vector<string> groups = split_list(get_option(argc, argv, "successors", "8,16,64"));
+
+    ofstream csv;
+    string csv_path = get_option(argc, argv, "csv", "");
+    if ( !csv_path.empty() ) {
+        csv.open( csv_path );
+        csv << "ids,table_bytes,successors,single_mlookups,batch_mlookups,speedup" << endl;
+    }
+
+    cout << "ids        table MB  successors  single M/s  batch M/s  speedup" << endl;
+    for ( const string& count : split_list(get_option(argc, argv, "ids", "1000000,64000000")) ) {
+        size_t ids = stoul(count);
+        mt19937 rng { seed };
+        vector<uint32_t> stored;
+        stored.reserve( ids );
+        ClosedSet set;
+        for ( size_t i=0; i<ids; ++i ) {
+            stored.push_back( rng() );
+            set.insert( stored.back() );
+        }
+        // The table doubles at half full: its size follows from the count.
+        size_t slots = 1024;
+        while ( slots < 2 * set.size() )
+            slots *= 2;
+        size_t table_bytes = slots * sizeof(uint32_t);
+
+        vector<uint32_t> queries;
+        queries.reserve( lookups );
+        uniform_int_distribution<size_t> pick { 0, ids - 1 };
+        for ( size_t i=0; i<lookups; ++i )
+            queries.push_back( i % 2 ? stored[pick(rng)] : rng() );
+
+        for ( const string& group : groups ) {
+            size_t successors = std::max<size_t>( stoul(group), 1 );
+
+            auto start = chrono::steady_clock::now();
+            size_t single_hits = 0;
+            for ( uint32_t id : queries )
+                single_hits += set.lookup( id );
+            chrono::duration<double> single = chrono::steady_clock::now() - start;
+
+            vector<uint8_t> found ( successors );
+            start = chrono::steady_clock::now();
+            size_t batch_hits = 0;
+            for ( size_t first=0; first<queries.size(); first+=successors ) {
+                size_t batch = std::min( successors, queries.size() - first );
+                batch_hits += set.lookup_batch( &queries[first], batch, found.data() );
+            }
+            chrono::duration<double> batched = chrono::steady_clock::now() - start;
+
+            if ( single_hits != batch_hits ) {
+                cerr << "lookup found " << single_hits << " IDs, lookup_batch " << batch_hits << endl;
+                return 1;
+            }
+            double single_rate = queries.size() / single.count() / 1e6;
+            double batch_rate = queries.size() / batched.count() / 1e6;
+            printf("%-10zu %8.1f %11zu %11.2f %10.2f %8.2f\n", ids, table_bytes / (1024.0 * 1024.0),
+                successors, single_rate, batch_rate, batch_rate / single_rate);
+            if ( csv.is_open() )
+                csv << ids << "," << table_bytes << "," << successors << "," << single_rate << ","
+                    << batch_rate << "," << batch_rate / single_rate << endl;
+        }
+    }
+}
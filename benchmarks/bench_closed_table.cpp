@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentClosedTable.h"
+#include "Options.h"
+
+using namespace std;
+
+/**
+    Shared closed table benchmark.
+
+    Every thread runs the closed list updates of a search on the
+    same table: it draws keys out of a fixed key space, so a share
+    of them are duplicates, with random g values, and calls
+    insert_or_decrease. For every thread count, reports updates
+    per second on ConcurrentClosedTable, which starts small and
+    grows as it goes, and on a std::map behind a mutex, then checks
+    both hold the same keys with the same g.
+
+    Usage: bench-closed-table [--threads=1,2,4,8,16,32]
+                              [--updates=2000000] [--keys=1000000]
+                              [--seed=1] [--csv=<file>]
+*/
+
+/* The baseline: what sharing a map like the ClosedSet of A* would take. */
+typedef struct locked_map_t
+{
+    mutex _lock;
+    map<uint64_t, uint32_t> _map;
+
+    void insert_or_decrease( uint64_t key, uint32_t g )
+    {
+        lock_guard<mutex> guard { _lock };
+        auto found = _map.emplace( key, g );
+        if ( !found.second && g < found.first->second )
+            found.first->second = g;
+    }
+} locked_map_t;
+
+/* 'updates' random keys out of 'keys', with random g values. */
+vector< pair<uint64_t, uint32_t> > make_updates( size_t updates, size_t keys, uint seed )
+{
+    mt19937_64 rng { seed };
+    uniform_int_distribution<size_t> pick { 0, keys - 1 };
+    uniform_int_distribution<uint32_t> cost { 0, 1000 };
+    vector< pair<uint64_t, uint32_t> > result;
+    result.reserve( updates );
+    for ( size_t i=0; i<updates; ++i ) {
+        // Zobrist hashes are random: scramble the key index the same way.
+        uint64_t key = (pick(rng) + 1) * 0xD6E8FEB86659FD93ull;
+        result.push_back( make_pair(key, cost(rng)) );
+    }
+    return result;
+}
+
+template<class Table>
+double run( Table& table, vector< vector< pair<uint64_t, uint32_t> > > const& work )
+{
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for ( auto const& updates : work )
+        pool.push_back( thread( [&table, &updates]() {
+            for ( pair<uint64_t, uint32_t> const& update : updates )
+                table.insert_or_decrease( update.first, update.second );
+        } ) );
+    for ( thread& t : pool )
+        t.join();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main( int argc, char* argv[] )
+{
+    size_t updates = stoul(get_option(argc, argv, "updates", "2000000"));
+    size_t keys = stoul(get_option(argc, argv, "keys", "1000000"));
+    uint seed = stoul(get_option(argc, argv, "seed", "1"));
+
+    ofstream csv;
+    string csv_path = get_option(argc, argv, "csv", "");
+    if ( !csv_path.empty() ) {
+        csv.open( csv_path );
+        csv << "threads,updates,keys,lock_free_mups,locked_map_mups,resizes,table_bytes" << endl;
+    }
+
+    cout << "updates: " << updates << " over " << keys << " keys, split between the threads" << endl;
+    cout << "threads  lock-free Mupd/s  locked map Mupd/s  resizes  table MB" << endl;
+    for ( const string& count : split_list(get_option(argc, argv, "threads", "1,2,4,8,16,32")) ) {
+        size_t threads = std::max<size_t>( stoul(count), 1 );
+        vector< vector< pair<uint64_t, uint32_t> > > work;
+        for ( size_t t=0; t<threads; ++t )
+            work.push_back( make_updates( updates / threads, keys, seed + t ) );
+
+        ConcurrentClosedTable table { 1024 };
+        double lock_free = run( table, work );
+        locked_map_t locked;
+        double baseline = run( locked, work );
+
+        if ( table.size() != locked._map.size() ) {
+            cerr << "Lock-free table holds " << table.size() << " keys, the map "
+                 << locked._map.size() << endl;
+            return 1;
+        }
+        for ( auto const& entry : locked._map ) {
+            uint32_t g = 0;
+            if ( !table.find( entry.first, g ) || g != entry.second ) {
+                cerr << "Key " << entry.first << " has g " << g << " instead of " << entry.second << endl;
+                return 1;
+            }
+        }
+
+        size_t total = threads * (updates / threads);
+        double mups = total / lock_free / 1e6, baseline_mups = total / baseline / 1e6;
+        printf("%7zu %17.2f %18.2f %8llu %9.1f\n", threads, mups, baseline_mups,
+            (unsigned long long) table.resizes(), table.size_in_bytes() / (1024.0 * 1024.0));
+        if ( csv.is_open() )
+            csv << threads << "," << total << "," << keys << "," << mups << "," << baseline_mups << ","
+                << table.resizes() << "," << table.size_in_bytes() << endl;
+    }
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Options.h"
+
+using namespace std;
+
+/**
+    Compare two 'bench-solver' CSV files.
+
+    Runs are grouped by (instance, heuristic) and the median of 
+    their repetitions compared. A group regresses when its time, 
+    peak RSS or expansions grow by more than the given relative 
+    tolerance, when it stops being solved, or when it is missing 
+    from the current results. Time also needs to grow by more than 
+    --min-time-delta seconds, so very short runs do not flap.
+
+    Usage: bench-compare <baseline.csv> <current.csv>
+                         [--time-tolerance=0.25] [--rss-tolerance=0.15]
+                         [--expansion-tolerance=0] [--min-time-delta=0.05]
+
+    Exits with 1 on regression, 2 on unreadable input.
+*/
+
+typedef struct bench_group_t
+{
+    vector<double> _seconds;
+    vector<double> _rss_kb;
+    vector<double> _expansions;
+    string _status;
+} bench_group_t;
+
+typedef map< pair<string, string>, bench_group_t > bench_groups_t;
+
+static double median( vector<double> values )
+{
+    if ( values.empty() )
+        return 0;
+    sort( values.begin(), values.end() );
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle-1] + values[middle]) / 2;
+}
+
+static vector<string> split_row( const string& line )
+{
+    vector<string> fields;
+    string field;
+    istringstream row { line };
+    while ( getline(row, field, ',') )
+        fields.push_back(field);
+    if ( !line.empty() && line.back() == ',' )
+        fields.push_back("");
+    return fields;
+}
+
+static bool read_results( const string& path, bench_groups_t& groups )
+{
+    ifstream csv { path };
+    string line;
+    if ( !getline(csv, line) ) {
+        cerr << "Cannot read " << path << endl;
+        return false;
+    }
+
+    map<string, size_t> column;
+    vector<string> header = split_row(line);
+    for ( size_t i=0; i<header.size(); ++i )
+        column[header[i]] = i;
+    for ( const char* name : { "instance", "heuristic", "status", "solve_seconds", "peak_rss_kb", "expansions" } ) {
+        if ( !column.count(name) ) {
+            cerr << path << ": missing column " << name << endl;
+            return false;
+        }
+    }
+
+    while ( getline(csv, line) ) {
+        vector<string> fields = split_row(line);
+        if ( fields.size() < header.size() )
+            continue;
+        bench_group_t& group = groups[ make_pair(fields[column["instance"]], fields[column["heuristic"]]) ];
+        group._status = fields[column["status"]];
+        group._seconds.push_back( stod(fields[column["solve_seconds"]]) );
+        group._rss_kb.push_back( stod(fields[column["peak_rss_kb"]]) );
+        group._expansions.push_back( stod(fields[column["expansions"]]) );
+    }
+    return true;
+}
+
+static bool grew( double baseline, double current, double tolerance )
+{
+    return current > baseline * (1 + tolerance);
+}
+
+int main( int argc, char* argv[] )
+{
+    vector<string> files = get_positional(argc, argv);
+    if ( files.size() != 2 ) {
+        cout << "Usage: bench-compare <baseline.csv> <current.csv> [--time-tolerance=0.25] "
+             << "[--rss-tolerance=0.15] [--expansion-tolerance=0] [--min-time-delta=0.05]" << endl;
+        return 2;
+    }
+    double time_tolerance = stod( get_option(argc, argv, "time-tolerance", "0.25") );
+    double rss_tolerance = stod( get_option(argc, argv, "rss-tolerance", "0.15") );
+    double expansion_tolerance = stod( get_option(argc, argv, "expansion-tolerance", "0") );
+    double min_time_delta = stod( get_option(argc, argv, "min-time-delta", "0.05") );
+
+    bench_groups_t baseline, current;
+    if ( !read_results(files[0], baseline) || !read_results(files[1], current) )
+        return 2;
+
+    int regressions = 0;
+    cout << left << setw(36) << "instance" << setw(24) << "heuristic" << right
+         << setw(12) << "time" << setw(12) << "rss" << setw(12) << "expansions" << "  verdict" << endl;
+    for ( auto& entry : baseline ) {
+        const bench_group_t& base = entry.second;
+        auto found = current.find( entry.first );
+        cout << left << setw(36) << entry.first.first << setw(24) << entry.first.second << right;
+        if ( found == current.end() ) {
+            cout << setw(36) << "" << "  REGRESSION (missing)" << endl;
+            ++regressions;
+            continue;
+        }
+        const bench_group_t& now = found->second;
+
+        double base_time = median(base._seconds), now_time = median(now._seconds);
+        double base_rss = median(base._rss_kb), now_rss = median(now._rss_kb);
+        double base_exp = median(base._expansions), now_exp = median(now._expansions);
+
+        vector<string> reasons;
+        if ( base._status == "solved" && now._status != "solved" )
+            reasons.push_back( "status " + now._status );
+        if ( grew(base_time, now_time, time_tolerance) && now_time - base_time > min_time_delta )
+            reasons.push_back( "time" );
+        if ( grew(base_rss, now_rss, rss_tolerance) )
+            reasons.push_back( "rss" );
+        if ( grew(base_exp, now_exp, expansion_tolerance) )
+            reasons.push_back( "expansions" );
+
+        auto change = [](double before, double after) {
+            ostringstream out;
+            out << showpos << fixed << setprecision(1)
+                << (before > 0 ? 100 * (after - before) / before : 0) << "%";
+            return out.str();
+        };
+        cout << setw(12) << change(base_time, now_time)
+             << setw(12) << change(base_rss, now_rss)
+             << setw(12) << change(base_exp, now_exp);
+        if ( reasons.empty() )
+            cout << "  ok" << endl;
+        else {
+            ++regressions;
+            cout << "  REGRESSION (";
+            for ( size_t i=0; i<reasons.size(); ++i )
+                cout << (i ? ", " : "") << reasons[i];
+            cout << ")" << endl;
+        }
+    }
+    for ( auto& entry : current ) {
+        if ( !baseline.count(entry.first) )
+            cout << left << setw(36) << entry.first.first << setw(24) << entry.first.second
+                 << right << setw(36) << "" << "  new" << endl;
+    }
+
+    cout << regressions << " regression(s) against " << files[0] << endl;
+    return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ExternalSearch.h"
+#include "Generator.h"
+#include "Options.h"
+#include "Parser.h"
+
+using namespace std;
+
+/**
+    External memory search benchmark.
+
+    Solves one instance with the external memory search under
+    several sort memory budgets and reports, per budget, the disk
+    traffic, the I/O throughput over the whole run and the peak
+    RSS, which should follow the budget and not the instance.
+
+    Every run happens in a child process so its peak RSS is its own.
+
+    Usage: bench-external [--problem=<file.probl>]
+                          [--stations=10] [--density=0.3] [--schools=2]
+                          [--passengers=6] [--capacity=4] [--seed=1]
+                          [--heuristic=all] [--sort-memory=1,16,256]
+                          [--work-dir=<dir>] [--csv=<file>]
+*/
+
+typedef struct external_result_t
+{
+    string _status          = "crashed";
+    double _seconds         = 0;
+    uint _cost              = 0;
+    uint64_t _expansions    = 0;
+    uint64_t _bytes_read    = 0;
+    uint64_t _bytes_written = 0;
+    long _peak_rss_kb       = 0;
+} external_result_t;
+
+static string read_file( const string& path )
+{
+    ifstream in { path };
+    stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+static external_result_t run_once( const string& text, const string& heuristic,
+    size_t sort_memory, const string& work_dir )
+{
+    external_result_t result;
+    int channel[2];
+    if ( pipe(channel) != 0 )
+        return result;
+
+    pid_t child = fork();
+    if ( child == 0 ) {
+        close(channel[0]);
+        problem_t problem = parse_problem( text );
+        problem.graph.precomputeShortestPaths();
+        ExternalSearch search( &problem.graph, problem.schools, problem.stations, problem.bus,
+            parse_heuristic(heuristic), work_dir + "/bench", work_dir, sort_memory );
+        search.set_verbose( false );
+        search.solve();
+
+        search_stats_t const& stats = search.get_stats();
+        ostringstream out;
+        out << status_to_str(search.get_status()) << " " << stats._elapsed_seconds << " "
+            << stats._solution_cost << " " << stats._number_of_expansions << " "
+            << stats._bytes_read << " " << stats._bytes_written << "\n";
+        string line = out.str();
+        ssize_t written = write(channel[1], line.data(), line.size());
+        _exit( written == static_cast<ssize_t>(line.size()) ? 0 : 1 );
+    }
+    close(channel[1]);
+
+    string line;
+    char buffer[256];
+    ssize_t n;
+    while ( (n = read(channel[0], buffer, sizeof(buffer))) > 0 )
+        line.append(buffer, static_cast<size_t>(n));
+    close(channel[0]);
+
+    int status = 0;
+    rusage usage {};
+    wait4(child, &status, 0, &usage);
+    result._peak_rss_kb = usage.ru_maxrss;
+    if ( !line.empty() ) {
+        istringstream fields { line };
+        fields >> result._status >> result._seconds >> result._cost >> result._expansions
+               >> result._bytes_read >> result._bytes_written;
+    }
+    return result;
+}
+
+int main( int argc, char* argv[] )
+{
+    string text;
+    string problem = get_option(argc, argv, "problem", "");
+    if ( !problem.empty() )
+        text = read_file( problem );
+    else {
+        instance_params_t params;
+        params._stations = stoul(get_option(argc, argv, "stations", "10"));
+        params._edge_density = stod(get_option(argc, argv, "density", "0.3"));
+        params._schools = stoul(get_option(argc, argv, "schools", "2"));
+        params._passengers = stoul(get_option(argc, argv, "passengers", "6"));
+        params._capacity = stoul(get_option(argc, argv, "capacity", "4"));
+        params._seed = stoul(get_option(argc, argv, "seed", "1"));
+        problem = params.name();
+        text = generate_instance( params );
+    }
+    string heuristic = get_option(argc, argv, "heuristic", "all");
+    string work_dir = get_option(argc, argv, "work-dir", "bench_external.work");
+    mkdir(work_dir.c_str(), 0755);
+
+    ofstream csv;
+    string csv_path = get_option(argc, argv, "csv", "");
+    if ( !csv_path.empty() ) {
+        csv.open( csv_path );
+        csv << "instance,heuristic,sort_memory_mb,status,seconds,cost,expansions,"
+            << "bytes_read,bytes_written,io_mb_per_second,peak_rss_kb" << endl;
+    }
+
+    cout << "instance: " << problem << ", heuristic: " << heuristic << endl;
+    cout << "sort MB  status       seconds   cost  expansions   read MB  written MB"
+         << "    MB/s  peak RSS MB" << endl;
+    for ( const string& budget : split_list(get_option(argc, argv, "sort-memory", "1,16,256")) ) {
+        double megabytes = stod(budget);
+        external_result_t result = run_once( text, heuristic,
+            static_cast<size_t>(megabytes * 1024 * 1024), work_dir );
+
+        double read_mb = result._bytes_read / (1024.0 * 1024.0);
+        double written_mb = result._bytes_written / (1024.0 * 1024.0);
+        double throughput = result._seconds > 0 ? (read_mb + written_mb) / result._seconds : 0;
+
+        printf("%7s  %-12s %8.3f %6u %11lu %9.1f %11.1f %7.1f %12.1f\n",
+            budget.c_str(), result._status.c_str(), result._seconds, result._cost,
+            static_cast<unsigned long>(result._expansions), read_mb, written_mb,
+            throughput, result._peak_rss_kb / 1024.0);
+        if ( csv.is_open() )
+            csv << problem << "," << heuristic << "," << budget << "," << result._status << ","
+                << result._seconds << "," << result._cost << "," << result._expansions << ","
+                << result._bytes_read << "," << result._bytes_written << ","
+                << throughput << "," << result._peak_rss_kb << endl;
+    }
+    rmdir(work_dir.c_str());
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ContractionHierarchy.h"
+#include "Generator.h"
+#include "Graph.h"
+#include "Options.h"
+
+using namespace std;
+
+/**
+    Contraction hierarchy benchmark.
+
+    For every map size, builds a road-like grid map and its
+    contraction hierarchy, then reports the preprocessing time,
+    the shortcuts added, the memory of the hierarchy and the time
+    per query against a Dijkstra search per query. A sample of
+    the queries is checked against Dijkstra, costs and unpacked
+    paths both, and any mismatch fails the benchmark.
+
+    Usage: bench-hierarchy [--stations=10000,30000,100000]
+                           [--queries=1000] [--checked=100]
+                           [--seed=1] [--csv=<file>]
+*/
+
+/* Cost of 'path' over 'graph', UINT32_MAX if some step is no edge. */
+uint path_cost( Graph const& graph, vector<uint> const& path )
+{
+    uint cost = 0;
+    for ( size_t i=1; i<path.size(); ++i ) {
+        int step = graph.getCost( path[i - 1], path[i] );
+        if ( step <= 0 )
+            return UINT32_MAX;
+        cost += step;
+    }
+    return cost;
+}
+
+int main( int argc, char* argv[] )
+{
+    size_t queries = stoul(get_option(argc, argv, "queries", "1000"));
+    size_t checked = stoul(get_option(argc, argv, "checked", "100"));
+    uint seed = stoul(get_option(argc, argv, "seed", "1"));
+
+    ofstream csv;
+    string csv_path = get_option(argc, argv, "csv", "");
+    if ( !csv_path.empty() ) {
+        csv.open( csv_path );
+        csv << "stations,edges,shortcuts,memory_bytes,build_seconds,"
+            << "us_per_query,us_per_dijkstra" << endl;
+    }
+
+    cout << "stations     edges  shortcuts  memory MB  build s  us/query  us/dijkstra" << endl;
+    for ( const string& size : split_list(get_option(argc, argv, "stations", "10000,30000,100000")) ) {
+        instance_params_t params;
+        params._stations = stoul(size);
+        params._seed = seed;
+        uint columns = static_cast<uint>( ceil(sqrt(double(params._stations))) );
+        vector<Edge> edges = generate_grid_map( params, columns );
+        Graph graph( edges, params._stations );
+
+        mt19937 rng { seed };
+        uniform_int_distribution<uint> station { 1, params._stations };
+        vector< pair<uint, uint> > pairs;
+        for ( size_t q=0; q<queries; ++q )
+            pairs.push_back( make_pair(station(rng), station(rng)) );
+
+        // Dijkstra first, before the graph has a hierarchy to answer with.
+        size_t dijkstras = std::min( checked, pairs.size() );
+        vector<uint> expected;
+        auto start = chrono::steady_clock::now();
+        for ( size_t q=0; q<dijkstras; ++q )
+            expected.push_back( graph.shortestDistance(pairs[q].first, pairs[q].second) );
+        chrono::duration<double> dijkstra = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        graph.precomputeContractionHierarchy();
+        chrono::duration<double> build = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        uint64_t checksum = 0;
+        for ( pair<uint, uint> const& query : pairs )
+            checksum += graph.shortestDistance( query.first, query.second );
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        for ( size_t q=0; q<dijkstras; ++q ) {
+            uint src = pairs[q].first, dest = pairs[q].second;
+            uint cost = graph.shortestDistance( src, dest );
+            vector<uint> path = graph.shortestPath( src, dest );
+            bool valid = !path.empty() && path.front() == src && path.back() == dest
+                && path_cost( graph, path ) == cost;
+            if ( cost != expected[q] || !valid ) {
+                cerr << "Hierarchy cost " << cost << " over a path of " << path_cost( graph, path )
+                     << ", Dijkstra " << expected[q] << ", from P" << src << " to P" << dest << endl;
+                return 1;
+            }
+        }
+
+        size_t shortcuts = graph.getContractionHierarchy()->shortcuts();
+        size_t memory = graph.getContractionHierarchy()->size_in_bytes();
+        double us = pairs.empty() ? 0 : 1e6 * elapsed.count() / pairs.size();
+        double us_dijkstra = dijkstras ? 1e6 * dijkstra.count() / dijkstras : 0;
+        printf("%8u %9zu %10zu %10.2f %8.2f %9.2f %12.1f\n", params._stations, edges.size(),
+            shortcuts, memory / (1024.0 * 1024.0), build.count(), us, us_dijkstra);
+        if ( csv.is_open() )
+            csv << params._stations << "," << edges.size() << "," << shortcuts << "," << memory << ","
+                << build.count() << "," << us << "," << us_dijkstra << endl;
+        if ( checksum == 0 && !pairs.empty() )
+            cerr << "Every cost was 0" << endl;
+    }
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Generator.h"
+#include "Graph.h"
+#include "Options.h"
+
+using namespace std;
+
+/**
+    Landmark lower bound benchmark.
+
+    Builds a random map, draws random pairs of stations and, for
+    every number of landmarks, reports the memory the landmarks
+    take, how long picking them took, the time per query and how
+    close the bounds are to the exact costs. Costs are compared
+    saturated at INT8_MAX, as the heuristics see them.
+
+    Usage: bench-landmarks [--stations=10000] [--density=0.0005]
+                           [--landmarks=1,2,4,8,16,32] [--sources=16]
+                           [--queries=100000] [--seed=1] [--csv=<file>]
+*/
+
+typedef struct landmark_query_t
+{
+    uint _src;
+    uint _dest;
+    uint _exact;
+} landmark_query_t;
+
+int main( int argc, char* argv[] )
+{
+    instance_params_t params;
+    params._stations = stoul(get_option(argc, argv, "stations", "10000"));
+    params._edge_density = stod(get_option(argc, argv, "density", "0.0005"));
+    params._seed = stoul(get_option(argc, argv, "seed", "1"));
+    uint sources = stoul(get_option(argc, argv, "sources", "16"));
+    size_t queries = stoul(get_option(argc, argv, "queries", "100000"));
+
+    vector<Edge> edges = generate_map( params );
+    Graph graph( edges, params._stations );
+
+    // Exact costs from a few sources to random destinations.
+    mt19937 rng { params._seed };
+    uniform_int_distribution<uint> station { 1, params._stations };
+    vector<landmark_query_t> pairs;
+    for ( uint s=0; s<sources; ++s ) {
+        uint src = station(rng);
+        vector<uint> exact = graph.shortestPathCosts( src );
+        for ( size_t q=0; q < queries / sources; ++q ) {
+            uint dest = station(rng);
+            pairs.push_back( landmark_query_t { src, dest, std::min<uint>(exact[dest - 1], INT8_MAX) } );
+        }
+    }
+    shuffle( pairs.begin(), pairs.end(), rng );
+
+    ofstream csv;
+    string csv_path = get_option(argc, argv, "csv", "");
+    if ( !csv_path.empty() ) {
+        csv.open( csv_path );
+        csv << "stations,edges,landmarks,memory_bytes,table_bytes,build_seconds,"
+            << "ns_per_query,mean_bound_ratio,exact_share" << endl;
+    }
+
+    double table_mb = double(params._stations) * params._stations * sizeof(uint) / (1024 * 1024);
+    cout << "stations: " << params._stations << ", edges: " << edges.size()
+         << ", distance table: " << table_mb << " MB" << endl;
+    cout << "landmarks  memory MB  build s  ns/query  bound/exact  exact" << endl;
+    for ( const string& count : split_list(get_option(argc, argv, "landmarks", "1,2,4,8,16,32")) ) {
+        size_t landmarks = stoul(count);
+        auto start = chrono::steady_clock::now();
+        graph.precomputeLandmarks( landmarks );
+        chrono::duration<double> build = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        uint64_t checksum = 0;
+        for ( landmark_query_t const& query : pairs )
+            checksum += graph.landmarkLowerBound( query._src, query._dest );
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        double ratio = 0;
+        size_t measured = 0, exact = 0;
+        for ( landmark_query_t const& query : pairs ) {
+            uint bound = graph.landmarkLowerBound( query._src, query._dest );
+            if ( bound > query._exact ) {
+                cerr << "Inadmissible bound " << bound << " over " << query._exact
+                     << " from P" << query._src << " to P" << query._dest << endl;
+                return 1;
+            }
+            if ( query._exact == 0 )
+                continue;
+            ratio += double(bound) / query._exact;
+            ++measured;
+            exact += bound == query._exact;
+        }
+        ratio = measured ? ratio / measured : 1;
+        double share = measured ? double(exact) / measured : 1;
+        size_t memory = 2 * landmarks * params._stations * sizeof(int32_t);
+        double ns = pairs.empty() ? 0 : 1e9 * elapsed.count() / pairs.size();
+
+        printf("%9zu %10.2f %8.3f %9.1f %12.3f %6.3f\n", landmarks, memory / (1024.0 * 1024.0),
+            build.count(), ns, ratio, share);
+        if ( csv.is_open() )
+            csv << params._stations << "," << edges.size() << "," << landmarks << "," << memory << ","
+                << size_t(params._stations) * params._stations * sizeof(uint) << "," << build.count() << ","
+                << ns << "," << ratio << "," << share << endl;
+        if ( checksum == 0 && !pairs.empty() )
+            cerr << "Every bound was 0" << endl;
+    }
+}
@@ -0,0 +1,61 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+#include "Generator.h"
+#include "Parser.h"
+
+using namespace std;
+
+/**
+    Parse throughput benchmark.
+
+    Writes a dense '.probl' map of the requested size and parses
+    it several times, reporting MB/s.
+
+    Usage: bench-parser [stations] [repetitions]
+*/
+
+int main( int argc, char* argv[] )
+{
+    uint stations = argc > 1 ? stoul(argv[1]) : 1500;
+    uint repetitions = argc > 2 ? stoul(argv[2]) : 5;
+
+    instance_params_t params;
+    params._stations = stations;
+    params._edge_density = 0.5;
+    params._schools = 2;
+    params._passengers = stations;
+    params._max_cost = 99;
+    params._seed = 42;
+
+    string path = "bench_parser_" + to_string(stations) + ".probl";
+    ofstream { path } << generate_instance(params);
+
+    struct stat info;
+    stat(path.c_str(), &info);
+    double megabytes = static_cast<double>(info.st_size) / (1024.0 * 1024.0);
+
+    double best = 1e300, total = 0;
+    size_t checksum = 0;
+    for ( uint r=0; r<repetitions; ++r ) {
+        auto start = chrono::steady_clock::now();
+        problem_t problem = parse_problem_file(path);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        checksum += problem.graph.getVectorCount() + problem.schools.size();
+        best = min(best, elapsed.count());
+        total += elapsed.count();
+    }
+    remove(path.c_str());
+
+    cout << "stations:     " << stations << endl;
+    cout << "input size:   " << megabytes << " MB" << endl;
+    cout << "best time:    " << best << " s" << endl;
+    cout << "mean time:    " << total / repetitions << " s" << endl;
+    cout << "throughput:   " << megabytes / best << " MB/s" << endl;
+    cout << "checksum:     " << checksum << endl;
+}
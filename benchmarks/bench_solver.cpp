@@ -0,0 +1,258 @@
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Generator.h"
+#include "GraphReduction.h"
+#include "Options.h"
+#include "Parser.h"
+#include "PerfCounters.h"
+#include "Solver.h"
+
+using namespace std;
+
+/**
+    Solver benchmark.
+
+    Runs every heuristic over a set of instances, either generated 
+    from the cross product of the parameter lists or read from 
+    '.probl' files, and appends a CSV row per run with wall time, 
+    expansions per second, peak RSS and solution cost, followed by
+    the hardware counters of the search, see PerfCounters.h, and
+    its last level cache misses per expansion. Counters the
+    machine does not provide are left empty.
+
+    Every run happens in a child process so its peak RSS is its own 
+    and a run blowing up its memory or time budget does not stop 
+    the benchmark.
+
+    Like the command line A* given --generic, it searches the map
+    reduced to the relevant stations, see GraphReduction, unless
+    given --no-reduce.
+
+    Usage: bench-solver [--stations=6,8] [--density=0.3] [--schools=1,2]
+                        [--passengers=2] [--capacity=5] [--seeds=1,2,3]
+                        [--problems=a.probl,b.probl]
+                        [--heuristics=none,all] [--repetitions=3]
+                        [--timeout=<seconds>] [--memory-limit=<MB>]
+                        [--keep-instances=<dir>] [--csv=<file>]
+                        [--no-reduce]
+*/
+
+typedef struct bench_instance_t
+{
+    string _name;
+    string _text;
+    instance_params_t _params;
+    bool _generated;
+} bench_instance_t;
+
+typedef struct bench_result_t
+{
+    string _status          = "crashed";
+    double _wall_seconds    = 0;
+    double _solve_seconds   = 0;
+    uint _cost              = 0;
+    uint64_t _expansions    = 0;
+    long _peak_rss_kb       = 0;
+    /* Empty if the counter is unavailable. */
+    string _counters[PerfCounters::COUNTERS];
+} bench_result_t;
+
+static vector<uint> uint_list( const string& value )
+{
+    vector<uint> result;
+    for ( const string& item : split_list(value) )
+        result.push_back( stoul(item) );
+    return result;
+}
+
+static vector<double> double_list( const string& value )
+{
+    vector<double> result;
+    for ( const string& item : split_list(value) )
+        result.push_back( stod(item) );
+    return result;
+}
+
+static string read_file( const string& path )
+{
+    ifstream in { path };
+    stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+/**
+    Solve 'instance' in a child process and collect its outcome.
+*/
+static bench_result_t run_once( const bench_instance_t& instance, const string& heuristic,
+    uint timeout, size_t memory_limit, bool reduce )
+{
+    bench_result_t result;
+    int channel[2];
+    if ( pipe(channel) != 0 )
+        return result;
+
+    auto start = chrono::steady_clock::now();
+    pid_t child = fork();
+    if ( child == 0 ) {
+        close(channel[0]);
+        if ( timeout != 0 )
+            alarm(timeout);
+
+        problem_t problem = parse_problem( instance._text );
+        problem.graph.precomputeShortestPaths();
+        shared_ptr<GraphReduction> reduction;
+        if ( reduce )
+            reduction = make_shared<GraphReduction>( problem.graph, problem.stations,
+                problem.bus, problem.schools );
+        Solver solver( reduction ? &reduction->graph() : &problem.graph,
+            reduction ? reduction->schools() : problem.schools,
+            reduction ? reduction->stations() : problem.stations,
+            reduction ? reduction->bus() : problem.bus,
+            parse_heuristic(heuristic), instance._name );
+        if ( reduction )
+            solver.set_reduction( reduction );
+        solver.set_verbose( false );
+        solver.set_memory_limit( memory_limit );
+        PerfCounters counters;
+        counters.start();
+        solver.solve();
+        counters.stop();
+
+        ostringstream out;
+        out << status_to_str(solver.get_status()) << " " << solver.get_elapsed_seconds() << " "
+            << solver.get_solution_cost() << " " << solver.get_number_of_expansions();
+        for ( int c=0; c<PerfCounters::COUNTERS; ++c ) {
+            PerfCounters::counter_t counter = static_cast<PerfCounters::counter_t>(c);
+            out << " ";
+            if ( counters.available(counter) )
+                out << counters.value(counter);
+            else
+                out << "-";
+        }
+        out << "\n";
+        string line = out.str();
+        ssize_t written = write(channel[1], line.data(), line.size());
+        _exit( written == static_cast<ssize_t>(line.size()) ? 0 : 1 );
+    }
+    close(channel[1]);
+
+    string line;
+    char buffer[256];
+    ssize_t n;
+    while ( (n = read(channel[0], buffer, sizeof(buffer))) > 0 )
+        line.append(buffer, static_cast<size_t>(n));
+    close(channel[0]);
+
+    int status = 0;
+    rusage usage {};
+    wait4(child, &status, 0, &usage);
+    chrono::duration<double> wall = chrono::steady_clock::now() - start;
+    result._wall_seconds = wall.count();
+    result._peak_rss_kb = usage.ru_maxrss;
+
+    if ( WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM )
+        result._status = "timeout";
+    else if ( !line.empty() ) {
+        istringstream fields { line };
+        fields >> result._status >> result._solve_seconds >> result._cost >> result._expansions;
+        for ( string& counter : result._counters ) {
+            fields >> counter;
+            if ( counter == "-" )
+                counter.clear();
+        }
+    }
+    return result;
+}
+
+int main( int argc, char* argv[] )
+{
+    vector<string> heuristics = split_list( get_option(argc, argv, "heuristics", "none,all") );
+    uint repetitions = stoul( get_option(argc, argv, "repetitions", "3") );
+    uint timeout = stoul( get_option(argc, argv, "timeout", "60") );
+    size_t memory_limit = static_cast<size_t>(
+        stod(get_option(argc, argv, "memory-limit", "2048")) * 1024 * 1024 );
+    string csv_path = get_option(argc, argv, "csv", "bench_results.csv");
+    string keep = get_option(argc, argv, "keep-instances", "");
+    bool reduce = !has_option(argc, argv, "no-reduce");
+
+    vector<bench_instance_t> instances;
+    if ( has_option(argc, argv, "problems") ) {
+        for ( const string& path : split_list(get_option(argc, argv, "problems", "")) ) {
+            size_t slash = path.find_last_of('/');
+            instances.push_back( bench_instance_t { 
+                slash == string::npos ? path : path.substr(slash + 1), 
+                read_file(path), instance_params_t(), false } );
+        }
+    }
+    else {
+        for ( uint stations : uint_list(get_option(argc, argv, "stations", "6,8")) )
+        for ( double density : double_list(get_option(argc, argv, "density", "0.3")) )
+        for ( uint schools : uint_list(get_option(argc, argv, "schools", "1,2")) )
+        for ( uint passengers : uint_list(get_option(argc, argv, "passengers", "2")) )
+        for ( uint capacity : uint_list(get_option(argc, argv, "capacity", "5")) )
+        for ( uint seed : uint_list(get_option(argc, argv, "seeds", "1,2,3")) ) {
+            instance_params_t params;
+            params._stations = stations;
+            params._edge_density = density;
+            params._schools = schools;
+            params._passengers = passengers;
+            params._capacity = capacity;
+            params._seed = seed;
+            instances.push_back( bench_instance_t { params.name(), generate_instance(params), params, true } );
+        }
+    }
+
+    ofstream csv { csv_path };
+    string header = "instance,stations,density,schools,passengers,capacity,seed,heuristic,"
+        "repetition,status,wall_seconds,solve_seconds,expansions,expansions_per_second,"
+        "peak_rss_kb,cost";
+    for ( int c=0; c<PerfCounters::COUNTERS; ++c )
+        header += "," + PerfCounters::name( static_cast<PerfCounters::counter_t>(c) );
+    header += ",cache_misses_per_expansion";
+    csv << header << endl;
+    cout << header << endl;
+
+    for ( const bench_instance_t& instance : instances ) {
+        if ( !keep.empty() && instance._generated )
+            ofstream { keep + "/" + instance._name + ".probl" } << instance._text;
+
+        for ( const string& heuristic : heuristics ) {
+            for ( uint r=1; r<=repetitions; ++r ) {
+                bench_result_t result = run_once( instance, heuristic, timeout, memory_limit, reduce );
+                double rate = result._solve_seconds > 0 ? result._expansions / result._solve_seconds : 0;
+
+                ostringstream row;
+                row << instance._name << ",";
+                if ( instance._generated )
+                    row << instance._params._stations << "," << instance._params._edge_density << ","
+                        << instance._params._schools << "," << instance._params._passengers << ","
+                        << instance._params._capacity << "," << instance._params._seed << ",";
+                else
+                    row << ",,,,,,";
+                row << heuristic << "," << r << "," << result._status << ","
+                    << result._wall_seconds << "," << result._solve_seconds << ","
+                    << result._expansions << "," << rate << ","
+                    << result._peak_rss_kb << "," << result._cost;
+                for ( const string& counter : result._counters )
+                    row << "," << counter;
+                row << ",";
+                string const& misses = result._counters[PerfCounters::CACHE_MISSES];
+                if ( !misses.empty() && result._expansions > 0 )
+                    row << stod(misses) / result._expansions;
+                csv << row.str() << endl;
+                cout << row.str() << endl;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include <iostream>
+#include <string>
+
+#include "Generator.h"
+#include "Options.h"
+
+using namespace std;
+
+/**
+    Write a synthetic '.probl' instance to the standard output.
+
+    Usage: bench-generate [--stations=9] [--density=0.2] [--schools=1]
+                          [--passengers=2] [--capacity=5] [--seed=1]
+                          [--max-cost=20]
+*/
+int main( int argc, char* argv[] )
+{
+    instance_params_t params;
+    params._stations = stoul( get_option(argc, argv, "stations", to_string(params._stations)) );
+    params._edge_density = stod( get_option(argc, argv, "density", to_string(params._edge_density)) );
+    params._schools = stoul( get_option(argc, argv, "schools", to_string(params._schools)) );
+    params._passengers = stoul( get_option(argc, argv, "passengers", to_string(params._passengers)) );
+    params._capacity = stoul( get_option(argc, argv, "capacity", to_string(params._capacity)) );
+    params._seed = stoul( get_option(argc, argv, "seed", to_string(params._seed)) );
+    params._max_cost = stoul( get_option(argc, argv, "max-cost", to_string(params._max_cost)) );
+
+    cout << generate_instance( params );
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "Batch.h"
+#include "Parser.h"
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+mutex output_lock;
+
+string directory_of( const string& path )
+{
+    size_t slash = path.find_last_of('/');
+    return slash == string::npos ? "" : path.substr(0, slash + 1);
+}
+
+} // namespace
+
+vector<batch_job_t> BatchRunner::read_manifest( const string& path, size_t default_memory_limit )
+{
+    ifstream manifest { path };
+    if ( !manifest )
+        throw runtime_error( "cannot open manifest " + path );
+
+    string base = directory_of( path );
+    vector<batch_job_t> jobs;
+    string line;
+    uint line_number = 0;
+    while ( getline(manifest, line) ) {
+        ++line_number;
+        istringstream fields { line };
+        string problem, heuristic;
+        if ( !(fields >> problem) || problem[0] == '#' )
+            continue;
+        if ( !(fields >> heuristic) )
+            throw runtime_error( path + ":" + to_string(line_number) + ": missing heuristic" );
+        if ( heuristic_name(parse_heuristic(heuristic)) != heuristic )
+            throw runtime_error( path + ":" + to_string(line_number) + ": unknown heuristic '" + heuristic + "'" );
+
+        size_t memory_limit = default_memory_limit;
+        double megabytes;
+        if ( fields >> megabytes )
+            memory_limit = static_cast<size_t>(megabytes * 1024 * 1024);
+
+        if ( problem[0] != '/' )
+            problem = base + problem;
+        jobs.push_back( batch_job_t(problem, heuristic_name(parse_heuristic(heuristic)), memory_limit) );
+    }
+    return jobs;
+}
+
+void BatchRunner::run()
+{
+    atomic<size_t> next { 0 };
+    atomic<size_t> done { 0 };
+    auto worker = [this, &next, &done]() {
+        for ( size_t i = next++; i < _jobs.size(); i = next++ ) {
+            run_job( _jobs[i] );
+
+            lock_guard<mutex> guard { output_lock };
+            cout << "[" << ++done << "/" << _jobs.size() << "] "
+                 << _jobs[i]._problem << " " << _jobs[i]._heuristic << ": "
+                 << _jobs[i]._status << " (" << _jobs[i]._elapsed_seconds << " s)" << endl;
+        }
+    };
+
+    vector<thread> pool;
+    for ( uint i=0; i < _workers && i < _jobs.size(); ++i )
+        pool.push_back( thread(worker) );
+    for ( thread& t : pool )
+        t.join();
+}
+
+void BatchRunner::run_job( batch_job_t& job )
+{
+    problem_t problem;
+    try {
+        problem = parse_problem_file( job._problem );
+    }
+    catch ( const exception& e ) {
+        job._status = "parse_error";
+        lock_guard<mutex> guard { output_lock };
+        cerr << job._problem << ": " << e.what() << endl;
+        return;
+    }
+
+    shared_ptr<const Graph> graph = _graphs.acquire( problem.graph );
+    Solver solver( graph.get(), problem.schools, problem.stations, problem.bus,
+        parse_heuristic(job._heuristic), job._problem + "." + job._heuristic );
+    solver.set_verbose( false );
+    solver.set_memory_limit( job._memory_limit );
+
+    if ( solver.solve() ) {
+        solver.write_stats_file();
+        solver.write_down_solution_file();
+    }
+    if ( _json_stats )
+        solver.write_json_stats_file();
+
+    job._status = status_to_str( solver.get_status() );
+    job._elapsed_seconds = solver.get_elapsed_seconds();
+    job._solution_cost = solver.get_solution_cost();
+    job._number_of_stops = solver.get_number_of_stops();
+    job._number_of_expansions = solver.get_number_of_expansions();
+}
+
+void BatchRunner::write_summary( const string& path ) const
+{
+    ofstream summary { path };
+    summary << "problem,heuristic,status,time_seconds,cost,stops,expansions" << endl;
+    for ( const batch_job_t& job : _jobs ) {
+        summary << job._problem << ","
+                << job._heuristic << ","
+                << job._status << ","
+                << job._elapsed_seconds << ","
+                << job._solution_cost << ","
+                << job._number_of_stops << ","
+                << job._number_of_expansions << endl;
+    }
+}
+
+const vector<batch_job_t>& BatchRunner::get_jobs() const { return _jobs; }
+
+void BatchRunner::set_json_stats( bool enabled ) { _json_stats = enabled; }
@@ -0,0 +1,94 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include "GraphCache.h"
+#include "Solver.h"
+
+using namespace std;
+
+/**
+    One (problem, heuristic) pair of a batch manifest and, once 
+    run, the outcome of its search.
+*/
+typedef struct batch_job_t
+{
+    batch_job_t( string problem, string heuristic, size_t memory_limit )
+    : _problem { problem }
+    , _heuristic { heuristic }
+    , _memory_limit { memory_limit }
+    {}
+
+    string _problem;
+    string _heuristic;
+    size_t _memory_limit;           /* Bytes, zero means no limit. */
+
+    /* Outcome */
+    string _status                  = "pending";
+    double _elapsed_seconds         = 0;
+    uint _solution_cost             = 0;
+    uint64_t _number_of_stops       = 0;
+    uint64_t _number_of_expansions  = 0;
+
+} batch_job_t;
+
+/**
+    Solves the problems listed on a manifest concurrently on 
+    a pool of worker threads.
+
+    Every job writes the usual '.output' and '.statistics' files 
+    named '<problem>.<heuristic>', as the testing script does. 
+    Jobs over the same map share one graph and its precomputed 
+    shortest path table through a GraphCache.
+*/
+class BatchRunner
+{
+public:
+    BatchRunner( vector<batch_job_t> jobs, uint workers )
+    : _jobs { jobs }
+    , _workers { workers == 0 ? 1 : workers }
+    , _graphs {}
+    {}
+
+    /**
+        Read a manifest with a job per line:
+
+            <problem.probl> <heuristic> [<memory limit in MB>]
+
+        Blank lines and lines starting with '#' are ignored. 
+        Relative problem paths are resolved against the manifest 
+        directory. Jobs without a memory limit get 'default_memory_limit'.
+
+        Throws runtime_error if the manifest cannot be read, or a
+        line misses its heuristic or names an unknown one.
+    */
+    static vector<batch_job_t> read_manifest( const string& path, size_t default_memory_limit );
+
+    /**
+        Run every job and return when all of them finished.
+    */
+    void run();
+
+    /**
+        Write a line per job with its outcome as CSV.
+    */
+    void write_summary( const string& path ) const;
+
+    const vector<batch_job_t>& get_jobs() const;
+
+    /**
+        Also write the '.statistics.json' file of every job.
+    */
+    void set_json_stats( bool enabled );
+
+private:
+    vector<batch_job_t> _jobs;
+    uint _workers;
+    GraphCache _graphs;
+    bool _json_stats = false;
+
+    void run_job( batch_job_t& job );
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "Checkpoint.h"
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace std;
+
+SnapshotWriter::SnapshotWriter( const string& path )
+: _path { path }
+, _temporary { path + ".tmp" }
+, _file { fopen(_temporary.c_str(), "wb") }
+{
+    if ( !_file )
+        throw runtime_error( "cannot create " + _temporary );
+    setvbuf(_file, nullptr, _IOFBF, 1 << 20);
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    if ( _file ) {
+        fclose(_file);
+        unlink(_temporary.c_str());
+    }
+}
+
+void SnapshotWriter::bytes( const void* data, size_t size )
+{
+    if ( fwrite(data, 1, size, _file) != size )
+        throw runtime_error( "cannot write " + _temporary );
+}
+
+void SnapshotWriter::u8( uint8_t value ) { bytes(&value, sizeof(value)); }
+
+void SnapshotWriter::u32( uint32_t value ) { bytes(&value, sizeof(value)); }
+
+void SnapshotWriter::u64( uint64_t value ) { bytes(&value, sizeof(value)); }
+
+void SnapshotWriter::f64( double value ) { bytes(&value, sizeof(value)); }
+
+void SnapshotWriter::str( const string& value )
+{
+    u32( static_cast<uint32_t>(value.size()) );
+    bytes( value.data(), value.size() );
+}
+
+void SnapshotWriter::commit()
+{
+    FILE* file = _file;
+    _file = nullptr;
+    if ( fflush(file) != 0 || fsync(fileno(file)) != 0 || fclose(file) != 0 ) {
+        unlink(_temporary.c_str());
+        throw runtime_error( "cannot write " + _temporary );
+    }
+    if ( rename(_temporary.c_str(), _path.c_str()) != 0 )
+        throw runtime_error( "cannot write " + _path );
+}
+
+
+SnapshotReader::SnapshotReader( const string& path )
+: _path { path }
+, _file { fopen(path.c_str(), "rb") }
+{
+    if ( !_file )
+        throw runtime_error( "cannot open " + path );
+    setvbuf(_file, nullptr, _IOFBF, 1 << 20);
+}
+
+SnapshotReader::~SnapshotReader()
+{
+    fclose(_file);
+}
+
+void SnapshotReader::bytes( void* data, size_t size )
+{
+    if ( fread(data, 1, size, _file) != size )
+        throw runtime_error( _path + " is truncated" );
+}
+
+uint8_t SnapshotReader::u8() { uint8_t value; bytes(&value, sizeof(value)); return value; }
+
+uint32_t SnapshotReader::u32() { uint32_t value; bytes(&value, sizeof(value)); return value; }
+
+uint64_t SnapshotReader::u64() { uint64_t value; bytes(&value, sizeof(value)); return value; }
+
+double SnapshotReader::f64() { double value; bytes(&value, sizeof(value)); return value; }
+
+string SnapshotReader::str()
+{
+    string value ( u32(), '\0' );
+    bytes( &value[0], value.size() );
+    return value;
+}
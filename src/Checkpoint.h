@@ -0,0 +1,63 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+/**
+    Sequential writer of a binary snapshot. Data goes to a
+    temporary file that only replaces 'path' on 'commit', so a
+    crash while writing leaves the previous snapshot intact.
+
+    Values are stored in the byte order of the machine, as the
+    snapshot is only meant to be read back where it was written.
+    Throws runtime_error on I/O errors.
+*/
+class SnapshotWriter
+{
+public:
+    SnapshotWriter( const string& path );
+    ~SnapshotWriter();
+
+    void u8( uint8_t value );
+    void u32( uint32_t value );
+    void u64( uint64_t value );
+    void f64( double value );
+    void str( const string& value );
+    void bytes( const void* data, size_t size );
+
+    /* Flush and move the snapshot into place. */
+    void commit();
+
+private:
+    string _path;
+    string _temporary;
+    FILE* _file;
+};
+
+/**
+    Reader of a snapshot written by SnapshotWriter.
+    Throws runtime_error on I/O errors or a truncated file.
+*/
+class SnapshotReader
+{
+public:
+    SnapshotReader( const string& path );
+    ~SnapshotReader();
+
+    uint8_t u8();
+    uint32_t u32();
+    uint64_t u64();
+    double f64();
+    string str();
+    void bytes( void* data, size_t size );
+
+private:
+    string _path;
+    FILE* _file;
+};
+
+#endif
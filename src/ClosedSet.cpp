@@ -0,0 +1,102 @@
+#include "ClosedSet.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+ClosedSet::ClosedSet()
+: _slots ( INITIAL_SLOTS, EMPTY_SLOT )
+, _mask { INITIAL_SLOTS - 1 }
+, _size { 0 }
+, _has_empty_id { false }
+{}
+
+void ClosedSet::insert( uint32_t id ) 
+{
+    if ( id == EMPTY_SLOT ) {
+        _size += !_has_empty_id;
+        _has_empty_id = true;
+        return;
+    }
+    // Grow at half full, so probes stay short.
+    if ( 2 * (_size + 1) > _slots.size() )
+        grow();
+    size_t index = home(id);
+    while ( _slots[index] != EMPTY_SLOT ) {
+        if ( _slots[index] == id )
+            return;
+        index = (index + 1) & _mask;
+    }
+    _slots[index] = id;
+    ++_size;
+}
+
+bool ClosedSet::probe( size_t index, uint32_t id ) const
+{
+    while ( _slots[index] != EMPTY_SLOT ) {
+        if ( _slots[index] == id )
+            return true;
+        index = (index + 1) & _mask;
+    }
+    return false;
+}
+
+bool ClosedSet::lookup( uint32_t id ) const
+{
+    if ( id == EMPTY_SLOT )
+        return _has_empty_id;
+    return probe( home(id), id );
+}
+
+size_t ClosedSet::lookup_batch( uint32_t const* ids, size_t count, uint8_t* found ) const
+{
+    size_t hits = 0;
+    size_t homes[LOOKUP_BATCH];
+    for ( size_t first=0; first<count; first+=LOOKUP_BATCH ) {
+        size_t batch = std::min( LOOKUP_BATCH, count - first );
+        for ( size_t i=0; i<batch; ++i ) {
+            homes[i] = home( ids[first + i] );
+            __builtin_prefetch( &_slots[homes[i]] );
+        }
+        for ( size_t i=0; i<batch; ++i ) {
+            uint32_t id = ids[first + i];
+            found[first + i] = id == EMPTY_SLOT ? _has_empty_id : probe( homes[i], id );
+            hits += found[first + i];
+        }
+    }
+    return hits;
+}
+
+size_t ClosedSet::size() const
+{
+    return _size;
+}
+
+void ClosedSet::visit( const function<void(uint32_t)>& visitor ) const
+{
+    vector<uint32_t> ids;
+    ids.reserve( _size );
+    if ( _has_empty_id )
+        ids.push_back( EMPTY_SLOT );
+    for ( uint32_t id : _slots )
+        if ( id != EMPTY_SLOT )
+            ids.push_back( id );
+    sort( ids.begin(), ids.end() );
+    for ( uint32_t id : ids )
+        visitor( id );
+}
+
+void ClosedSet::grow()
+{
+    vector<uint32_t> old ( _slots.size() * 2, EMPTY_SLOT );
+    old.swap( _slots );
+    _mask = _slots.size() - 1;
+    for ( uint32_t id : old ) {
+        if ( id == EMPTY_SLOT )
+            continue;
+        size_t index = home(id);
+        while ( _slots[index] != EMPTY_SLOT )
+            index = (index + 1) & _mask;
+        _slots[index] = id;
+    }
+}
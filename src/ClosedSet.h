@@ -1,5 +1,5 @@
-#ifndef ORDEREDSET_H
-#define ORDEREDSET_H
+#ifndef CLOSEDSET_H
+#define CLOSEDSET_H
 /**
     The purpose of this class is to implement a fast look up
     datastructure to use as closed 'list' on the search task. 
@@ -8,16 +8,16 @@
     to verify if a node has already been expanded or not to 
     know if we can discard it. 
 
-    It is required to make this class as fast as possible. So
-    we are using Policy-Based Data Structures for its 
-    implementation. 
+    It is required to make this class as fast as possible. IDs
+    are kept in an open addressing hash table, so a lookup is a
+    single cache miss, and 'lookup_batch' overlaps the misses of
+    many lookups. The IDs are not kept in any order.
 */
-#include <functional> // for less 
+#include <cstdint>
+#include <functional>
+#include <vector>
 #include "Types.h"
 
-//#include <set>
-#include <map>
-
 using namespace std;
 
 typedef struct expanded_t
@@ -118,41 +118,68 @@ typedef struct expanded_t
 } expanded_t;
 
 
-class OrderedSet 
+class ClosedSet 
 {   
 public: 
     /**
-        Create an empty ordered set. 
+        Create an empty set. 
     */
-    OrderedSet() 
-    : oset{}
-    {}
+    ClosedSet();
     
     /**
-        Insert a hashed node value with complexity O(log n). 
+        Insert the ID of an expanded node in amortized O(1). 
+        How the node was reached is kept in the PathStore.
     */
-    void insert( expanded_t to_insert );
+    void insert( uint32_t id );
     
     /**
         Returns true  if the lookup was successful, false otherwise. 
     */
-    bool lookup( expanded_t to_lookup );
-    
+    bool lookup( uint32_t id ) const;
+
     /**
-        Retrieve expanded state. 
+        Look 'count' IDs up at once, setting 'found[i]' to whether
+        'ids[i]' is stored. The slots of up to LOOKUP_BATCH IDs are
+        prefetched before any is read, so on tables larger than the
+        cache their misses overlap instead of following each other.
+        Returns how many were found.
     */
-    expanded_t recover( uint32_t id );
+    size_t lookup_batch( uint32_t const* ids, size_t count, uint8_t* found ) const;
 
-    ~OrderedSet() 
+    /**
+        Number of stored nodes.
+    */
+    size_t size() const;
+
+    /**
+        Call 'visitor' on every stored ID, in increasing order, 
+        so a checkpoint does not depend on the table layout. 
+        Sorts a copy of the IDs.
+    */
+    void visit( const function<void(uint32_t)>& visitor ) const;
+
+    /* IDs prefetched at a time by 'lookup_batch'. */
+    static const size_t LOOKUP_BATCH = 32;
+
+private:
+    /* Linear probing over a power of 2 slots, EMPTY_SLOT for none.
+       ID EMPTY_SLOT itself is kept apart. */
+    vector<uint32_t> _slots;
+    uint64_t _mask;
+    size_t _size;
+    bool _has_empty_id;
+
+    static constexpr uint32_t EMPTY_SLOT = 0;
+    static const size_t INITIAL_SLOTS = 1024;
+
+    size_t home( uint32_t id ) const
     {
-        for (auto pos = oset.begin(); pos != oset.end(); ++pos)
-        {
-            delete pos->second;
-        }
+        return (static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ull >> 32) & _mask;
     }
 
-private:
-    std::map <uint32_t, expanded_t const*> oset;
+    bool probe( size_t index, uint32_t id ) const;
+
+    void grow();
 };
 
 #endif
@@ -0,0 +1,43 @@
+#include "CompactSearch.h"
+
+using namespace std;
+
+vector<compact_class_t> compact_classes( vector<station_t> const& stations, bus_t const& bus )
+{
+    vector<compact_class_t> classes;
+    auto add = [&classes]( passenger_t const& passenger ) {
+        for ( compact_class_t& known : classes ) {
+            if ( known._origin == passenger._origin_id && known._destination == passenger._destination_id ) {
+                ++known._count;
+                return;
+            }
+        }
+        classes.push_back( compact_class_t { passenger._origin_id, passenger._destination_id, 1 } );
+    };
+    for ( station_t const& station : stations )
+        for ( passenger_t const& passenger : station._passengers )
+            add( passenger );
+    for ( passenger_t const& passenger : bus._passengers )
+        add( passenger );
+    return classes;
+}
+
+unique_ptr<SearchEngine> make_compact_search( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename )
+{
+    if ( stations.size() > COMPACT_MAX_STATIONS || bus._max_passengers > COMPACT_MAX_COUNT )
+        return nullptr;
+
+    vector<compact_class_t> classes = compact_classes( stations, bus );
+    for ( compact_class_t const& passenger_class : classes ) {
+        if ( passenger_class._count > COMPACT_MAX_COUNT )
+            return nullptr;
+    }
+
+    if ( classes.size() <= 16 )
+        return unique_ptr<SearchEngine>( new CompactSearch<16>( graph, schools, stations, bus, heuristic, filename ) );
+    if ( classes.size() <= 64 )
+        return unique_ptr<SearchEngine>( new CompactSearch<64>( graph, schools, stations, bus, heuristic, filename ) );
+    return nullptr;
+}
@@ -0,0 +1,386 @@
+#ifndef COMPACTSEARCH_H
+#define COMPACTSEARCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+#include "SearchEngine.h"
+#include "State.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    Problem sizes the compact states can hold. Stations are bits
+    of a 64 bit word and every count is a byte.
+*/
+static const size_t COMPACT_MAX_STATIONS = 64;
+static const size_t COMPACT_MAX_COUNT = UINT8_MAX;
+
+/**
+    Passenger class of the compact search: all passengers going
+    from '_origin' to '_destination'.
+*/
+typedef struct compact_class_t
+{
+    uint _origin;
+    uint _destination;
+    uint _count;
+} compact_class_t;
+
+/**
+    The passenger classes of a problem, in the order they are
+    first found at the stations and then on the bus.
+*/
+vector<compact_class_t> compact_classes( vector<station_t> const& stations, bus_t const& bus );
+
+/**
+    Configuration of the problem held in place: the bus station,
+    the passengers of every class waiting and on board, and a
+    bitset of the stations where somebody is waiting.
+*/
+template<size_t CLASSES>
+struct compact_state_t
+{
+    uint64_t _waiting_stations;
+    uint8_t _station;
+    uint8_t _on_board_total;
+    uint8_t _waiting[CLASSES];
+    uint8_t _on_board[CLASSES];
+
+    bool operator == ( compact_state_t const& other ) const
+    {
+        return _station == other._station
+            && memcmp( _waiting, other._waiting, CLASSES ) == 0
+            && memcmp( _on_board, other._on_board, CLASSES ) == 0;
+    }
+};
+
+template<size_t CLASSES>
+struct compact_state_hash_t
+{
+    size_t operator () ( compact_state_t<CLASSES> const& state ) const
+    {
+        // FNV-1a over the fields that tell states apart.
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash]( uint8_t byte ) { hash = (hash ^ byte) * 1099511628211ull; };
+        mix( state._station );
+        for ( size_t c=0; c<CLASSES; ++c ) {
+            mix( state._waiting[c] );
+            mix( state._on_board[c] );
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+/**
+    A* over fixed size states for problems of up to 64 stations,
+    CLASSES passenger classes and 255 passengers per class or on
+    the bus. States are plain values, so nodes live in a single
+    vector and nothing is allocated per state.
+
+    Passengers of a class can not be told apart, so states are
+    identified by their configuration, as in ExternalSearch, and
+    an operator moves one passenger of a class. The heuristics of
+    state_t are consistent, so a state is first expanded with its
+    lowest g; a state reached again with a lower g is still
+    reopened, so solutions stay optimal with any admissible one.
+
+    Use make_compact_search, which picks CLASSES for the problem.
+    The default A* search takes it whenever it fits.
+*/
+template<size_t CLASSES>
+class CompactSearch : public SearchEngine
+{
+public:
+    CompactSearch( Graph const * graph, vector<school_t> schools,
+        vector<station_t>& stations, bus_t& bus,
+        heuristic_t heuristic, string filename );
+
+    bool solve() override;
+
+    /* Allocator and container bookkeeping per state of the seen table. */
+    static const size_t SEEN_NODE_OVERHEAD = 32;
+    static const size_t OPEN_NODE_OVERHEAD = 48;
+
+private:
+    typedef compact_state_t<CLASSES> key_t;
+
+    static const uint8_t TRANSIT = 0;
+    static const uint8_t EMBARK = 1;
+    static const uint8_t DISEMBARK = 2;
+    static const uint32_t NO_NODE = UINT32_MAX;
+
+    typedef struct node_t
+    {
+        key_t _state;
+        uint _g;
+        uint32_t _parent;
+        uint8_t _action;
+        /* Class of the passenger moved. */
+        uint8_t _class;
+        bool _closed;
+    } node_t;
+
+    vector<compact_class_t> _classes;
+    size_t _station_count;
+    uint8_t _origin_station;
+    uint8_t _capacity;
+    bool _deliver;
+    bool _collect;
+
+    /* Transitions out of every station and the distance table. */
+    vector< vector<Transition> > _neighbors;
+    vector<uint> _distances;
+
+    key_t _initial;
+    vector<node_t> _nodes;
+    unordered_map<key_t, uint32_t, compact_state_hash_t<CLASSES> > _seen;
+    multimap<uint, uint32_t> _open;
+
+    uint distance( uint from, uint to ) const
+    {
+        return _distances[ (from - 1) * COMPACT_MAX_STATIONS + (to - 1) ];
+    }
+
+    uint heuristic( key_t const& state );
+
+    bool is_final( key_t const& state ) const;
+
+    void push( key_t const& state, uint g, uint32_t parent, uint8_t action, uint8_t passenger_class );
+
+    string recover( uint32_t node );
+
+    size_t estimate_memory_use() const;
+};
+
+/**
+    The compact search instance that fits the dimensions of the
+    problem, or nullptr if it is too large for any of them.
+*/
+unique_ptr<SearchEngine> make_compact_search( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename );
+
+
+template<size_t CLASSES>
+CompactSearch<CLASSES>::CompactSearch( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename )
+: SearchEngine { schools, filename }
+, _classes { compact_classes( stations, bus ) }
+, _station_count { stations.size() }
+, _origin_station { static_cast<uint8_t>(bus._origin_station) }
+, _capacity { static_cast<uint8_t>(bus._max_passengers) }
+, _deliver { heuristic == heuristic_t::ALL || heuristic == heuristic_t::MAX_DISTANCE_PASSENGER }
+, _collect { heuristic == heuristic_t::ALL || heuristic == heuristic_t::MAX_DISTANCE_STATION }
+, _distances ( COMPACT_MAX_STATIONS * COMPACT_MAX_STATIONS, 0 )
+{
+    for ( uint from=1; from<=_station_count; ++from ) {
+        _neighbors.push_back( graph->getNeighbors(from) );
+        for ( uint to=1; to<=_station_count; ++to )
+            _distances[ (from - 1) * COMPACT_MAX_STATIONS + (to - 1) ] = graph->shortestPathCost(from, to);
+    }
+
+    memset( &_initial, 0, sizeof(_initial) );
+    _initial._station = static_cast<uint8_t>(bus._current_station);
+    for ( size_t c=0; c<_classes.size(); ++c ) {
+        for ( station_t const& station : stations )
+            for ( passenger_t const& passenger : station._passengers )
+                if ( passenger._origin_id == _classes[c]._origin && passenger._destination_id == _classes[c]._destination )
+                    ++_initial._waiting[c];
+        for ( passenger_t const& passenger : bus._passengers )
+            if ( passenger._origin_id == _classes[c]._origin && passenger._destination_id == _classes[c]._destination )
+                ++_initial._on_board[c];
+        _initial._on_board_total += _initial._on_board[c];
+        if ( _initial._waiting[c] != 0 )
+            _initial._waiting_stations |= uint64_t(1) << (_classes[c]._origin - 1);
+    }
+
+    _stats._bytes_per_open_node = sizeof(pair<uint, uint32_t>) + OPEN_NODE_OVERHEAD;
+    _stats._bytes_per_closed_node = sizeof(pair<key_t, uint32_t>) + SEEN_NODE_OVERHEAD;
+}
+
+template<size_t CLASSES>
+uint CompactSearch<CLASSES>::heuristic( key_t const& state )
+{
+    ++_stats._heuristic_evaluations;
+    uint h = 0;
+    if ( _deliver ) {
+        for ( size_t c=0; c<_classes.size(); ++c )
+            if ( state._on_board[c] != 0 )
+                h = std::max( h, distance( state._station, _classes[c]._destination ) );
+    }
+    if ( _collect ) {
+        for ( uint64_t bits = state._waiting_stations; bits != 0; bits &= bits - 1 )
+            h = std::max( h, distance( state._station, __builtin_ctzll(bits) + 1 ) );
+    }
+    return h;
+}
+
+template<size_t CLASSES>
+bool CompactSearch<CLASSES>::is_final( key_t const& state ) const
+{
+    return state._station == _origin_station && state._on_board_total == 0 && state._waiting_stations == 0;
+}
+
+template<size_t CLASSES>
+void CompactSearch<CLASSES>::push( key_t const& state, uint g, uint32_t parent,
+    uint8_t action, uint8_t passenger_class )
+{
+    ++_stats._generated;
+    auto seen = _seen.find( state );
+    if ( seen != _seen.end() ) {
+        node_t const& previous = _nodes[seen->second];
+        if ( previous._g <= g ) {
+            ++_stats._duplicates_pruned;
+            return;
+        }
+        if ( previous._closed )
+            ++_stats._reopened;
+    }
+
+    uint32_t index = static_cast<uint32_t>(_nodes.size());
+    _nodes.push_back( node_t { state, g, parent, action, passenger_class, false } );
+    if ( seen != _seen.end() )
+        seen->second = index;
+    else
+        _seen.emplace( state, index );
+    _open.emplace( g + heuristic(state), index );
+    ++_stats._stored;
+}
+
+template<size_t CLASSES>
+bool CompactSearch<CLASSES>::solve()
+{
+    auto start = std::chrono::steady_clock::now();
+    _solved = false;
+    _status = search_status_t::EXHAUSTED;
+
+    push( _initial, 0, NO_NODE, TRANSIT, 0 );
+    if (_verbose)
+        cout << "Search started";
+    while ( !_open.empty() ) {
+        if (_memory_limit != 0 && estimate_memory_use() > _memory_limit) {
+            _status = search_status_t::MEMORY_LIMIT;
+            break;
+        }
+        if (deadline_passed()) {
+            _status = search_status_t::DEADLINE;
+            break;
+        }
+        if (_stop_requested) {
+            _status = search_status_t::INTERRUPTED;
+            break;
+        }
+
+        uint32_t index = _open.begin()->second;
+        _open.erase( _open.begin() );
+        node_t& node = _nodes[index];
+        // Superseded by a cheaper path to the same state.
+        if ( _seen.find(node._state)->second != index || node._closed )
+            continue;
+
+        if ( is_final(node._state) ) {
+            if (_verbose)
+                cout << "success!" << endl << flush;
+            _solved = true;
+            _status = search_status_t::SOLVED;
+            _stats._solution_cost = node._g;
+            _solution = recover( index );
+            break;
+        }
+
+        node._closed = true;
+        if (_stats._number_of_expansions % 100000 == 0 && _verbose)
+            cout << "." << flush;
+        ++_stats._number_of_expansions;
+
+        // 'node' is not used past here: pushing may move '_nodes'.
+        key_t const state = node._state;
+        uint g = node._g;
+
+        for ( Transition const& trip : _neighbors[state._station - 1] ) {
+            key_t next = state;
+            next._station = static_cast<uint8_t>(trip.destination);
+            push( next, g + trip.cost, index, TRANSIT, 0 );
+        }
+
+        for ( size_t c=0; c<_classes.size(); ++c ) {
+            if ( state._on_board[c] != 0 && _classes[c]._destination == state._station ) {
+                key_t next = state;
+                --next._on_board[c];
+                --next._on_board_total;
+                push( next, g + 1, index, DISEMBARK, static_cast<uint8_t>(c) );
+            }
+        }
+
+        if ( state._on_board_total < _capacity ) {
+            for ( size_t c=0; c<_classes.size(); ++c ) {
+                if ( state._waiting[c] != 0 && _classes[c]._origin == state._station ) {
+                    key_t next = state;
+                    --next._waiting[c];
+                    ++next._on_board[c];
+                    ++next._on_board_total;
+                    next._waiting_stations &= ~(uint64_t(1) << (state._station - 1));
+                    for ( size_t other=0; other<_classes.size(); ++other )
+                        if ( next._waiting[other] != 0 && _classes[other]._origin == state._station )
+                            next._waiting_stations |= uint64_t(1) << (state._station - 1);
+                    push( next, g + 1, index, EMBARK, static_cast<uint8_t>(c) );
+                }
+            }
+        }
+
+        _stats._peak_open = std::max<uint64_t>( _stats._peak_open, _open.size() );
+        _stats._peak_closed = _seen.size();
+        _stats._peak_memory_estimate = std::max( _stats._peak_memory_estimate, estimate_memory_use() );
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    _stats._elapsed_seconds = elapsed.count();
+    _stats._timeline.push_back( make_pair( _stats._elapsed_seconds, _stats._number_of_expansions ) );
+
+    if ( !_solved && _verbose ) {
+        if (_status == search_status_t::MEMORY_LIMIT)
+            cout << endl << "Memory limit reached." << endl;
+        else if (_status == search_status_t::DEADLINE)
+            cout << endl << "Deadline reached." << endl;
+        else if (_status == search_status_t::INTERRUPTED)
+            cout << endl << "Interrupted." << endl;
+        else
+            cout << endl << "No solution could be found." << endl;
+    }
+    return _solved;
+}
+
+template<size_t CLASSES>
+string CompactSearch<CLASSES>::recover( uint32_t index )
+{
+    vector<expanded_t> ordered_recovery;
+    for ( ; index != NO_NODE; index = _nodes[index]._parent ) {
+        node_t const& node = _nodes[index];
+        ordered_recovery.push_back( expanded_t (
+            0, 0,
+            node._state._station,
+            node._action == EMBARK,
+            node._action == DISEMBARK,
+            node._action == EMBARK ? _classes[node._class]._destination : 0 ) );
+    }
+    return format_route( ordered_recovery );
+}
+
+template<size_t CLASSES>
+size_t CompactSearch<CLASSES>::estimate_memory_use() const
+{
+    return _open.size() * _stats._bytes_per_open_node
+        + _seen.size() * _stats._bytes_per_closed_node
+        + _nodes.size() * sizeof(node_t);
+}
+
+#endif
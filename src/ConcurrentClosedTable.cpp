@@ -0,0 +1,263 @@
+#include "ConcurrentClosedTable.h"
+#include <algorithm>
+
+using namespace std;
+
+ConcurrentClosedTable::generation_t::generation_t( size_t capacity )
+: _capacity { capacity }
+, _mask { capacity - 1 }
+, _slots { new closed_slot_t[capacity] }
+, _chunks { (capacity + MIGRATION_CHUNK - 1) / MIGRATION_CHUNK }
+, _chunk_done { new std::atomic<bool>[_chunks] }
+{
+    for ( size_t i=0; i<capacity; ++i ) {
+        _slots[i]._key.store( EMPTY_KEY, memory_order_relaxed );
+        _slots[i]._g.store( UNSET_G, memory_order_relaxed );
+    }
+    for ( size_t i=0; i<_chunks; ++i )
+        _chunk_done[i].store( false, memory_order_relaxed );
+}
+
+ConcurrentClosedTable::ConcurrentClosedTable( size_t capacity )
+{
+    size_t slots = 1;
+    while ( slots < std::max<size_t>( capacity, 2 ) )
+        slots <<= 1;
+    _first = new generation_t( slots );
+    _current.store( _first, memory_order_release );
+}
+
+ConcurrentClosedTable::~ConcurrentClosedTable()
+{
+    generation_t* table = _first;
+    while ( table ) {
+        generation_t* next = table->_next.load( memory_order_relaxed );
+        delete table;
+        table = next;
+    }
+}
+
+ConcurrentClosedTable::result_t ConcurrentClosedTable::insert_or_decrease( uint64_t key, uint32_t g )
+{
+    return update( key, g, true );
+}
+
+bool ConcurrentClosedTable::insert_if_absent( uint64_t key, uint32_t g )
+{
+    return update( key, g, false ) == result_t::INSERTED;
+}
+
+size_t ConcurrentClosedTable::capacity() const
+{
+    return _current.load( memory_order_acquire )->_capacity;
+}
+
+size_t ConcurrentClosedTable::size_in_bytes() const
+{
+    size_t bytes = 0;
+    for ( generation_t const* table = _first; table; table = table->_next.load( memory_order_acquire ) )
+        bytes += table->_capacity * sizeof(closed_slot_t) + table->_chunks * sizeof(std::atomic<bool>);
+    return bytes;
+}
+
+uint64_t ConcurrentClosedTable::home( uint64_t key, uint64_t mask )
+{
+    // Fibonacci hashing, in case the keys are not random.
+    return (key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+}
+
+ConcurrentClosedTable::result_t ConcurrentClosedTable::update( uint64_t key, uint32_t g, bool decrease )
+{
+    if ( key == EMPTY_KEY )
+        key = EMPTY_KEY + 1;
+    else if ( key == MOVED_KEY )
+        key = MOVED_KEY - 1;
+    g = std::min( g, MAX_G );
+
+    result_t result = update_from( _current.load( memory_order_acquire ), key, g, decrease );
+    if ( result == result_t::INSERTED )
+        _size.fetch_add( 1, memory_order_relaxed );
+    return result;
+}
+
+ConcurrentClosedTable::result_t ConcurrentClosedTable::update_from( generation_t* table, uint64_t key, uint32_t g, bool decrease )
+{
+    result_t result;
+    while ( !try_update( table, key, g, decrease, result ) )
+        table = advance( table, key );
+    return result;
+}
+
+bool ConcurrentClosedTable::try_update( generation_t* table, uint64_t key, uint32_t g, bool decrease, result_t& result )
+{
+    if ( table->_next.load( memory_order_acquire ) )
+        return false;
+
+    uint64_t index = home( key, table->_mask );
+    for ( size_t probe=0; probe<table->_capacity; ++probe, index = (index + 1) & table->_mask ) {
+        closed_slot_t& slot = table->_slots[index];
+        uint64_t found = slot._key.load( memory_order_acquire );
+        if ( found == EMPTY_KEY ) {
+            if ( table->_used.load( memory_order_relaxed ) * 100 >= table->_capacity * MAX_LOAD_PERCENT ) {
+                grow( table );
+                return false;
+            }
+            if ( slot._key.compare_exchange_strong( found, key, memory_order_acq_rel ) ) {
+                table->_used.fetch_add( 1, memory_order_relaxed );
+                found = key;
+            }
+            // Otherwise another thread claimed or sealed the slot
+            // first: 'found' is its key.
+        }
+        if ( found == MOVED_KEY )
+            return false;
+        if ( found != key )
+            continue;
+
+        // Whoever sets the g first, claimer or not, inserts the key.
+        uint32_t current = slot._g.load( memory_order_acquire );
+        while ( true ) {
+            if ( current & FROZEN_G )
+                return false;
+            if ( current == UNSET_G ) {
+                if ( slot._g.compare_exchange_weak( current, g, memory_order_acq_rel ) ) {
+                    result = result_t::INSERTED;
+                    return true;
+                }
+                continue;
+            }
+            if ( !decrease || g >= current ) {
+                result = result_t::NOT_DECREASED;
+                return true;
+            }
+            if ( slot._g.compare_exchange_weak( current, g, memory_order_acq_rel ) ) {
+                result = result_t::DECREASED;
+                return true;
+            }
+        }
+    }
+    grow( table );
+    return false;
+}
+
+bool ConcurrentClosedTable::find( uint64_t key, uint32_t& g ) const
+{
+    if ( key == EMPTY_KEY )
+        key = EMPTY_KEY + 1;
+    else if ( key == MOVED_KEY )
+        key = MOVED_KEY - 1;
+    return find_in( _current.load( memory_order_acquire ), key, g );
+}
+
+bool ConcurrentClosedTable::find_in( generation_t const* table, uint64_t key, uint32_t& g )
+{
+    uint64_t index = home( key, table->_mask );
+    for ( size_t probe=0; probe<table->_capacity; ++probe, index = (index + 1) & table->_mask ) {
+        closed_slot_t const& slot = table->_slots[index];
+        uint64_t found = slot._key.load( memory_order_acquire );
+        // Linear probing never skips an empty slot, so the key is
+        // in the next table if anywhere, inserted since it grew.
+        if ( found == EMPTY_KEY || found == MOVED_KEY )
+            break;
+        if ( found != key )
+            continue;
+
+        uint32_t current = slot._g.load( memory_order_acquire );
+        uint32_t stored = current & ~FROZEN_G;
+        // Until the slot is frozen, no thread updated the key in the
+        // next table. Once it is, the copy may have been lowered.
+        uint32_t copied = 0;
+        bool moved = (current & FROZEN_G) && find_in( table->_next.load( memory_order_acquire ), key, copied );
+        if ( stored == UNSET_G && !moved )
+            return false;
+        g = moved ? std::min( stored, copied ) : stored;
+        return true;
+    }
+    generation_t const* next = table->_next.load( memory_order_acquire );
+    return next && find_in( next, key, g );
+}
+
+void ConcurrentClosedTable::grow( generation_t* table )
+{
+    if ( table->_next.load( memory_order_acquire ) )
+        return;
+    generation_t* bigger = new generation_t( table->_capacity * 2 );
+    generation_t* expected = nullptr;
+    if ( table->_next.compare_exchange_strong( expected, bigger, memory_order_acq_rel ) )
+        _resizes.fetch_add( 1, memory_order_relaxed );
+    else
+        delete bigger;
+}
+
+ConcurrentClosedTable::generation_t* ConcurrentClosedTable::advance( generation_t* table, uint64_t key )
+{
+    generation_t* next = table->_next.load( memory_order_acquire );
+    help_migrate( table );
+    copy_key( table, key );
+    return next;
+}
+
+void ConcurrentClosedTable::help_migrate( generation_t* table )
+{
+    generation_t* next = table->_next.load( memory_order_acquire );
+    size_t chunk = table->_cursor.fetch_add( 1, memory_order_relaxed );
+    if ( chunk >= table->_chunks ) {
+        // All handed out: copy again one a thread has not finished,
+        // it may have been preempted.
+        chunk = table->_chunks;
+        for ( size_t i=0; i<table->_chunks && chunk == table->_chunks; ++i )
+            if ( !table->_chunk_done[i].load( memory_order_acquire ) )
+                chunk = i;
+        if ( chunk == table->_chunks ) {
+            generation_t* expected = table;
+            _current.compare_exchange_strong( expected, next, memory_order_acq_rel );
+            return;
+        }
+    }
+
+    size_t begin = chunk * MIGRATION_CHUNK;
+    size_t end = std::min( begin + MIGRATION_CHUNK, table->_capacity );
+    for ( size_t i=begin; i<end; ++i )
+        move_slot( table->_slots[i], next );
+    if ( !table->_chunk_done[chunk].exchange( true, memory_order_acq_rel ) &&
+         table->_migrated.fetch_add( 1, memory_order_acq_rel ) + 1 == table->_chunks ) {
+        generation_t* expected = table;
+        _current.compare_exchange_strong( expected, next, memory_order_acq_rel );
+    }
+}
+
+void ConcurrentClosedTable::copy_key( generation_t* table, uint64_t key )
+{
+    generation_t* next = table->_next.load( memory_order_acquire );
+    uint64_t index = home( key, table->_mask );
+    for ( size_t probe=0; probe<table->_capacity; ++probe, index = (index + 1) & table->_mask ) {
+        closed_slot_t& slot = table->_slots[index];
+        uint64_t found = slot._key.load( memory_order_acquire );
+        if ( found == EMPTY_KEY || found == key ) {
+            move_slot( slot, next );
+            found = slot._key.load( memory_order_acquire );
+        }
+        // Sealed, so no thread can claim the key further on.
+        if ( found == MOVED_KEY || found == key )
+            return;
+    }
+}
+
+void ConcurrentClosedTable::move_slot( closed_slot_t& slot, generation_t* next )
+{
+    uint64_t key = slot._key.load( memory_order_acquire );
+    while ( key == EMPTY_KEY )
+        if ( slot._key.compare_exchange_weak( key, MOVED_KEY, memory_order_acq_rel ) )
+            return;
+    if ( key == MOVED_KEY )
+        return;
+
+    // Claimed but never set: the key is absent, and the thread that
+    // claimed it will find the slot frozen and go to the next table.
+    uint32_t g = slot._g.fetch_or( FROZEN_G, memory_order_acq_rel ) & ~FROZEN_G;
+    if ( g == UNSET_G )
+        return;
+    // Copies of the same slot lower the same key to the same g, so
+    // any number of threads can make them.
+    update_from( next, key, g, true );
+}
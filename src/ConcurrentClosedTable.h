@@ -0,0 +1,159 @@
+#ifndef CONCURRENTCLOSEDTABLE_H
+#define CONCURRENTCLOSEDTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+/**
+    Slot of the table: a configuration key and the cheapest g it
+    was reached with.
+*/
+typedef struct closed_slot_t
+{
+    std::atomic<uint64_t> _key;
+    std::atomic<uint32_t> _g;
+} closed_slot_t;
+
+/**
+    Lock-free closed table several search threads share: an open
+    addressing hash map from configuration keys, such as
+    SearchState::hash, to the cheapest g each was reached with.
+    No thread ever waits for another one.
+
+    A thread claims an empty slot with a compare and swap on its
+    key. The g starts unset, which reads as absent, and every
+    thread with that key, the one that claimed it or not, sets or
+    lowers it with compare and swap: the one that sets it
+    inserted the key. Slots are never emptied, so linear probing
+    stops at the first empty slot.
+
+    Once half full, the table grows into one twice as large and
+    updates go on in that one. Before updating a key there, a
+    thread copies the key's old slot over, so no value is lost,
+    and the threads that come by copy a chunk of the old slots
+    each. Copying freezes the slot and lowers the g of the new
+    one to its g, so any thread can copy a slot or a chunk again,
+    including chunks a preempted thread left half done. Old
+    tables are kept until the table is destroyed, as a slow
+    thread may still read them.
+
+    Keys are compared in full. Two values of the key are reserved
+    and stored as their neighbours; for hashes this is one more
+    collision among 2^64 values.
+*/
+class ConcurrentClosedTable
+{
+public:
+    enum class result_t { INSERTED, DECREASED, NOT_DECREASED };
+
+    /* A table of at least 'capacity' slots, rounded up to a power of 2. */
+    explicit ConcurrentClosedTable( size_t capacity = INITIAL_CAPACITY );
+    ~ConcurrentClosedTable();
+
+    ConcurrentClosedTable( ConcurrentClosedTable const& ) = delete;
+    ConcurrentClosedTable& operator=( ConcurrentClosedTable const& ) = delete;
+
+    /**
+        Store 'key' with 'g' if absent, or lower its g to 'g'.
+        A search prunes the state on NOT_DECREASED: it was
+        reached as cheaply before. 'g' is at most MAX_G.
+    */
+    result_t insert_or_decrease( uint64_t key, uint32_t g );
+
+    /* Store 'key' with 'g' if absent. Returns true if it was. */
+    bool insert_if_absent( uint64_t key, uint32_t g );
+
+    /* Find 'key', setting 'g' to its g. Returns false if absent. */
+    bool find( uint64_t key, uint32_t& g ) const;
+
+    /* Keys stored. */
+    size_t size() const { return _size.load( memory_order_relaxed ); }
+
+    /* Slots of the current table. */
+    size_t capacity() const;
+
+    /* Bytes held by every table, old ones included. */
+    size_t size_in_bytes() const;
+
+    uint64_t resizes() const { return _resizes.load( memory_order_relaxed ); }
+
+    static const size_t INITIAL_CAPACITY = 1 << 16;
+    static constexpr uint32_t MAX_G = 0x7FFFFFFE;
+
+    /* Percentage of used slots that makes the table grow. */
+    static const size_t MAX_LOAD_PERCENT = 50;
+
+    /* Slots a thread copies at a time while the table grows. */
+    static const size_t MIGRATION_CHUNK = 4096;
+
+private:
+    typedef struct generation_t
+    {
+        explicit generation_t( size_t capacity );
+
+        size_t _capacity;
+        uint64_t _mask;
+        unique_ptr<closed_slot_t[]> _slots;
+        std::atomic<size_t> _used { 0 };
+        /* The table this one grows into, owned by this one. */
+        std::atomic<generation_t*> _next { nullptr };
+        /* Chunks of MIGRATION_CHUNK slots: the next one no thread
+           copies yet, whether each was copied and how many were. */
+        size_t _chunks;
+        std::atomic<size_t> _cursor { 0 };
+        unique_ptr<std::atomic<bool>[]> _chunk_done;
+        std::atomic<size_t> _migrated { 0 };
+    } generation_t;
+
+    generation_t* _first;
+    std::atomic<generation_t*> _current;
+    std::atomic<size_t> _size { 0 };
+    std::atomic<uint64_t> _resizes { 0 };
+
+    result_t update( uint64_t key, uint32_t g, bool decrease );
+
+    /* Update 'key' from 'table' on, through the tables it grew into. */
+    result_t update_from( generation_t* table, uint64_t key, uint32_t g, bool decrease );
+
+    /**
+        Update 'key' in 'table'. Returns false, leaving 'result'
+        alone, if the table grows and the update must go to the
+        next one.
+    */
+    bool try_update( generation_t* table, uint64_t key, uint32_t g, bool decrease, result_t& result );
+
+    static bool find_in( generation_t const* table, uint64_t key, uint32_t& g );
+
+    /* Start growing 'table' unless another thread did. */
+    void grow( generation_t* table );
+
+    /* Copy a chunk of 'table', then the slot of 'key', into the
+       table it grows into, and return that one. */
+    generation_t* advance( generation_t* table, uint64_t key );
+
+    /* Copy one chunk of 'table' not copied yet, if any is left,
+       and move '_current' on once they all are. */
+    void help_migrate( generation_t* table );
+
+    /* Copy the slot of 'key' in 'table', if any, and seal the
+       empty slot ending its probe sequence. */
+    void copy_key( generation_t* table, uint64_t key );
+
+    /* Freeze 'slot' and lower its key in 'next' to its g. */
+    void move_slot( closed_slot_t& slot, generation_t* next );
+
+    static uint64_t home( uint64_t key, uint64_t mask );
+
+    /* Keys of empty slots and of empty slots sealed by a copy. */
+    static const uint64_t EMPTY_KEY = 0;
+    static const uint64_t MOVED_KEY = UINT64_MAX;
+    /* g of a slot claimed but not yet set, read as absent, and the
+       bit that freezes a slot being copied. */
+    static const uint32_t UNSET_G = 0x7FFFFFFF;
+    static const uint32_t FROZEN_G = 0x80000000;
+};
+
+#endif
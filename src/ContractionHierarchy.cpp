@@ -0,0 +1,392 @@
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include "Graph.h"
+
+using namespace std;
+
+namespace {
+
+typedef pair<uint32_t, uint32_t> heap_entry_t;
+
+const uint32_t INFINITE = UINT32_MAX;
+
+/**
+    Dijkstra state reused between searches: an entry is only
+    valid if its stamp is the one of the current search, so
+    nothing is cleared in between.
+*/
+typedef struct search_space_t
+{
+    vector<uint32_t> _cost;
+    vector<uint32_t> _stamp;
+    vector<uint32_t> _parent;
+    vector<uint32_t> _middle;
+    vector<heap_entry_t> _heap;
+    uint32_t _current = 0;
+
+    void start( size_t size )
+    {
+        if ( _cost.size() < size ) {
+            _cost.resize( size );
+            _stamp.resize( size, 0 );
+            _parent.resize( size );
+            _middle.resize( size );
+        }
+        _heap.clear();
+        if ( ++_current == 0 ) {
+            fill( _stamp.begin(), _stamp.end(), 0 );
+            _current = 1;
+        }
+    }
+
+    bool reached( uint32_t node ) const { return _stamp[node] == _current; }
+
+    uint32_t cost( uint32_t node ) const { return reached(node) ? _cost[node] : INFINITE; }
+
+    /* Lower the cost of 'node' if 'cost' is lower and queue it. */
+    void relax( uint32_t node, uint32_t cost, uint32_t parent, uint32_t middle )
+    {
+        if ( reached(node) && _cost[node] <= cost )
+            return;
+        _stamp[node] = _current;
+        _cost[node] = cost;
+        _parent[node] = parent;
+        _middle[node] = middle;
+        _heap.push_back( make_pair(cost, node) );
+        push_heap( _heap.begin(), _heap.end(), greater<heap_entry_t>() );
+    }
+
+    heap_entry_t pop()
+    {
+        pop_heap( _heap.begin(), _heap.end(), greater<heap_entry_t>() );
+        heap_entry_t top = _heap.back();
+        _heap.pop_back();
+        return top;
+    }
+
+    uint32_t top() const { return _heap.empty() ? INFINITE : _heap.front().first; }
+} search_space_t;
+
+thread_local search_space_t forward_space;
+thread_local search_space_t backward_space;
+
+/**
+    The map while it is being contracted: edges in and out of
+    every station left, shortcuts included. Contracting a station
+    moves its edges, all to stations contracted later, into '_up'
+    and '_down'.
+*/
+class Contraction
+{
+public:
+    Contraction( Graph const& graph )
+    : _size { graph.getVectorCount() }
+    , _up ( _size + 1 )
+    , _down ( _size + 1 )
+    , _out ( _size + 1 )
+    , _in ( _size + 1 )
+    , _deleted_neighbors ( _size + 1, 0 )
+    , _level ( _size + 1, 0 )
+    , _target ( _size + 1, 0 )
+    {
+        for ( uint from=1; from<=_size; ++from )
+            for ( Transition const& edge : graph.getNeighbors(from) )
+                if ( edge.destination != from )
+                    add_edge( from, edge.destination, edge.cost, hierarchy_edge_t::NO_MIDDLE );
+    }
+
+    /* Contract every station, least important first. */
+    void run()
+    {
+        priority_queue< pair<int, uint32_t>, vector< pair<int, uint32_t> >,
+            greater< pair<int, uint32_t> > > order;
+        for ( uint32_t node=1; node<=_size; ++node )
+            order.push( make_pair(priority(node), node) );
+
+        while ( !order.empty() ) {
+            uint32_t node = order.top().second;
+            order.pop();
+            // Lazy update: contract it only if it is still the least important.
+            int current = priority(node);
+            if ( !order.empty() && current > order.top().first ) {
+                order.push( make_pair(current, node) );
+                continue;
+            }
+            contract( node );
+        }
+    }
+
+    size_t _size;
+    /* Edges out of every station to the ones contracted after it,
+       and into every station from the ones contracted after it. */
+    vector< vector<hierarchy_edge_t> > _up;
+    vector< vector<hierarchy_edge_t> > _down;
+
+private:
+    vector< vector<hierarchy_edge_t> > _out;
+    vector< vector<hierarchy_edge_t> > _in;
+    vector<uint32_t> _deleted_neighbors;
+    /* Length of the longest shortcut chain down from the station. */
+    vector<uint32_t> _level;
+    search_space_t _witness;
+    /* Stations marked with '_target_stamp' are witness targets. */
+    vector<uint64_t> _target;
+    uint64_t _target_stamp = 0;
+
+    void contract( uint32_t node )
+    {
+        shortcuts( node, true );
+        for ( hierarchy_edge_t const& edge : _out[node] ) {
+            _up[node].push_back( edge );
+            remove_edge( _in[edge._node], node );
+            touch( edge._node, node );
+        }
+        for ( hierarchy_edge_t const& edge : _in[node] ) {
+            _down[node].push_back( edge );
+            remove_edge( _out[edge._node], node );
+            touch( edge._node, node );
+        }
+        vector<hierarchy_edge_t>().swap( _out[node] );
+        vector<hierarchy_edge_t>().swap( _in[node] );
+    }
+
+    /* 'neighbor' lost 'contracted', update its priority terms. */
+    void touch( uint32_t neighbor, uint32_t contracted )
+    {
+        ++_deleted_neighbors[neighbor];
+        _level[neighbor] = std::max( _level[neighbor], _level[contracted] + 1 );
+    }
+
+    static void remove_edge( vector<hierarchy_edge_t>& edges, uint32_t node )
+    {
+        for ( size_t i=0; i<edges.size(); ++i ) {
+            if ( edges[i]._node == node ) {
+                edges[i] = edges.back();
+                edges.pop_back();
+                return;
+            }
+        }
+    }
+
+    /* Add the edge, or lower the cost of the one already there. */
+    void add_edge( uint32_t from, uint32_t to, uint32_t cost, uint32_t middle )
+    {
+        for ( hierarchy_edge_t& edge : _out[from] ) {
+            if ( edge._node != to )
+                continue;
+            if ( cost < edge._cost ) {
+                edge = hierarchy_edge_t { to, cost, middle };
+                for ( hierarchy_edge_t& back : _in[to] )
+                    if ( back._node == from )
+                        back = hierarchy_edge_t { from, cost, middle };
+            }
+            return;
+        }
+        _out[from].push_back( hierarchy_edge_t { to, cost, middle } );
+        _in[to].push_back( hierarchy_edge_t { from, cost, middle } );
+    }
+
+    /**
+        Shortcuts contracting 'node' needs, added if 'add'. A
+        shortcut is needed unless a path as cheap avoids 'node'.
+    */
+    int shortcuts( uint32_t node, bool add )
+    {
+        int count = 0;
+        for ( size_t i=0; i<_in[node].size(); ++i ) {
+            hierarchy_edge_t incoming = _in[node][i];
+            uint32_t limit = 0;
+            for ( hierarchy_edge_t const& outgoing : _out[node] )
+                if ( outgoing._node != incoming._node )
+                    limit = std::max( limit, incoming._cost + outgoing._cost );
+            if ( limit == 0 )
+                continue;
+            // The successors a witness path may have to reach.
+            size_t targets = 0;
+            ++_target_stamp;
+            for ( hierarchy_edge_t const& outgoing : _out[node] ) {
+                if ( outgoing._node != incoming._node && _target[outgoing._node] != _target_stamp ) {
+                    _target[outgoing._node] = _target_stamp;
+                    ++targets;
+                }
+            }
+            // Estimating the priority settles for fewer witnesses.
+            witness( incoming._node, node, limit, targets,
+                add ? ContractionHierarchy::WITNESS_SETTLE_LIMIT : ContractionHierarchy::WITNESS_SETTLE_LIMIT / 10 );
+
+            for ( hierarchy_edge_t const& outgoing : _out[node] ) {
+                if ( outgoing._node == incoming._node )
+                    continue;
+                uint32_t through = incoming._cost + outgoing._cost;
+                if ( _witness.cost(outgoing._node) <= through )
+                    continue;
+                ++count;
+                if ( add )
+                    add_edge( incoming._node, outgoing._node, through, node );
+            }
+        }
+        return count;
+    }
+
+    /**
+        Costs from 'src' avoiding 'skip' into '_witness', until the
+        costs left are over 'limit', 'targets' stations of '_target'
+        are settled or 'settle_limit' stations are.
+    */
+    void witness( uint32_t src, uint32_t skip, uint32_t limit, size_t targets, size_t settle_limit )
+    {
+        _witness.start( _size + 1 );
+        _witness.relax( src, 0, 0, 0 );
+        size_t settled = 0;
+        while ( !_witness._heap.empty() && settled < settle_limit && targets != 0 ) {
+            heap_entry_t top = _witness.pop();
+            if ( top.first > _witness._cost[top.second] )
+                continue;
+            if ( top.first > limit )
+                break;
+            ++settled;
+            targets -= _target[top.second] == _target_stamp;
+            for ( hierarchy_edge_t const& edge : _out[top.second] )
+                if ( edge._node != skip )
+                    _witness.relax( edge._node, top.first + edge._cost, 0, 0 );
+        }
+    }
+
+    /* Edge difference, plus the neighbors already contracted and
+       the level to spread contraction evenly over the map. */
+    int priority( uint32_t node )
+    {
+        int removed = static_cast<int>(_out[node].size() + _in[node].size());
+        return 2 * (shortcuts( node, false ) - removed) + static_cast<int>(_deleted_neighbors[node])
+            + static_cast<int>(_level[node]);
+    }
+};
+
+} // namespace
+
+ContractionHierarchy::ContractionHierarchy( Graph const& graph )
+: _size { graph.getVectorCount() }
+, _shortcuts { 0 }
+{
+    Contraction contraction { graph };
+    contraction.run();
+
+    vector< vector<hierarchy_edge_t> > const& up = contraction._up;
+    vector< vector<hierarchy_edge_t> > const& down = contraction._down;
+    for ( uint32_t node=0; node<=_size; ++node ) {
+        _up_first.push_back( static_cast<uint32_t>(_up.size()) );
+        _up.insert( _up.end(), up[node].begin(), up[node].end() );
+        for ( hierarchy_edge_t const& edge : up[node] )
+            _shortcuts += edge._middle != hierarchy_edge_t::NO_MIDDLE;
+        _down_first.push_back( static_cast<uint32_t>(_down.size()) );
+        _down.insert( _down.end(), down[node].begin(), down[node].end() );
+        for ( hierarchy_edge_t const& edge : down[node] )
+            _shortcuts += edge._middle != hierarchy_edge_t::NO_MIDDLE;
+    }
+    _up_first.push_back( static_cast<uint32_t>(_up.size()) );
+    _down_first.push_back( static_cast<uint32_t>(_down.size()) );
+}
+
+pair<uint, uint> ContractionHierarchy::query( uint src, uint dest ) const
+{
+    forward_space.start( _size + 1 );
+    backward_space.start( _size + 1 );
+    forward_space.relax( src, 0, 0, hierarchy_edge_t::NO_MIDDLE );
+    backward_space.relax( dest, 0, 0, hierarchy_edge_t::NO_MIDDLE );
+
+    uint32_t best = INFINITE;
+    uint32_t meeting = 0;
+    while ( std::min( forward_space.top(), backward_space.top() ) < best ) {
+        bool forward = forward_space.top() <= backward_space.top();
+        search_space_t& space = forward ? forward_space : backward_space;
+        search_space_t const& other = forward ? backward_space : forward_space;
+        heap_entry_t top = space.pop();
+        uint32_t node = top.second;
+        if ( top.first > space._cost[node] )
+            continue;
+        if ( other.reached(node) && top.first + other._cost[node] < best ) {
+            best = top.first + other._cost[node];
+            meeting = node;
+        }
+
+        // Stall on demand: a higher station reaches this one cheaper,
+        // so the cost found is not the shortest and leads nowhere.
+        uint32_t const* first = forward ? &_down_first[node] : &_up_first[node];
+        hierarchy_edge_t const* edges = forward ? _down.data() : _up.data();
+        bool stalled = false;
+        for ( uint32_t e=first[0]; e<first[1] && !stalled; ++e ) {
+            uint32_t above = space.cost( edges[e]._node );
+            stalled = above != INFINITE && above + edges[e]._cost < top.first;
+        }
+        if ( stalled )
+            continue;
+
+        first = forward ? &_up_first[node] : &_down_first[node];
+        edges = forward ? _up.data() : _down.data();
+        for ( uint32_t e=first[0]; e<first[1]; ++e )
+            space.relax( edges[e]._node, top.first + edges[e]._cost, node, edges[e]._middle );
+    }
+    return make_pair( best, meeting );
+}
+
+uint ContractionHierarchy::distance( uint src, uint dest ) const
+{
+    if ( src == dest )
+        return 0;
+    return query( src, dest ).first;
+}
+
+vector<uint> ContractionHierarchy::path( uint src, uint dest ) const
+{
+    vector<uint> stations { src };
+    if ( src == dest )
+        return stations;
+    pair<uint, uint> found = query( src, dest );
+    if ( found.first == INFINITE )
+        return vector<uint>();
+
+    // Hierarchy edges from 'src' up to the meeting station, then down to 'dest'.
+    vector< pair<uint32_t, uint32_t> > up;
+    for ( uint32_t node = found.second; node != src; node = forward_space._parent[node] )
+        up.push_back( make_pair(node, forward_space._middle[node]) );
+    uint32_t from = src;
+    for ( auto step = up.rbegin(); step != up.rend(); ++step ) {
+        unpack( from, step->first, step->second, stations );
+        from = step->first;
+    }
+    for ( uint32_t node = found.second; node != dest; node = backward_space._parent[node] ) {
+        uint32_t next = backward_space._parent[node];
+        unpack( node, next, backward_space._middle[node], stations );
+    }
+    return stations;
+}
+
+void ContractionHierarchy::unpack( uint from, uint to, uint32_t middle, vector<uint>& path ) const
+{
+    if ( middle == hierarchy_edge_t::NO_MIDDLE ) {
+        path.push_back( to );
+        return;
+    }
+    unpack( from, middle, find_edge(from, middle)->_middle, path );
+    unpack( middle, to, find_edge(middle, to)->_middle, path );
+}
+
+hierarchy_edge_t const* ContractionHierarchy::find_edge( uint from, uint to ) const
+{
+    hierarchy_edge_t const* best = nullptr;
+    for ( uint32_t e=_up_first[from]; e<_up_first[from + 1]; ++e )
+        if ( _up[e]._node == to && (!best || _up[e]._cost < best->_cost) )
+            best = &_up[e];
+    for ( uint32_t e=_down_first[to]; e<_down_first[to + 1]; ++e )
+        if ( _down[e]._node == from && (!best || _down[e]._cost < best->_cost) )
+            best = &_down[e];
+    return best;
+}
+
+size_t ContractionHierarchy::size_in_bytes() const
+{
+    return (_up.size() + _down.size()) * sizeof(hierarchy_edge_t)
+        + (_up_first.size() + _down_first.size()) * sizeof(uint32_t);
+}
@@ -0,0 +1,92 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <sys/types.h>
+
+using namespace std;
+
+class Graph;
+
+/**
+    Edge of the hierarchy: an edge of the map, or a shortcut
+    standing for the path through 'middle'.
+*/
+typedef struct hierarchy_edge_t
+{
+    uint32_t _node;
+    uint32_t _cost;
+    /* Station the shortcut skips, NO_MIDDLE for map edges. */
+    uint32_t _middle;
+
+    static const uint32_t NO_MIDDLE = UINT32_MAX;
+} hierarchy_edge_t;
+
+/**
+    Contraction hierarchy of a directed map, for exact shortest
+    path costs between two stations without a table. It is built
+    over the edges 'Graph::getNeighbors' returns, the ones a bus
+    can take.
+
+    Stations are contracted one at a time, least important first
+    by edge difference: contracting a station adds a shortcut from
+    each of its predecessors to each of its successors unless a
+    bounded witness search finds a path as cheap without it. Every
+    edge then goes up or down in contraction order, and a query
+    is a Dijkstra search up from the source and one up the reversed
+    edges from the destination, which only settle a few stations.
+
+    Queries are thread safe: their scratch space is per thread.
+*/
+class ContractionHierarchy
+{
+public:
+    explicit ContractionHierarchy( Graph const& graph );
+
+    /* Exact cost from 'src' to 'dest', UINT32_MAX if unreachable. */
+    uint distance( uint src, uint dest ) const;
+
+    /**
+        Stations of a shortest path from 'src' to 'dest', both
+        included, empty if 'dest' cannot be reached.
+    */
+    vector<uint> path( uint src, uint dest ) const;
+
+    size_t shortcuts() const { return _shortcuts; }
+
+    /* Bytes held by the upward and downward edges. */
+    size_t size_in_bytes() const;
+
+    /* Stations settled per witness search before giving up, in
+       which case the shortcut is added anyway. */
+    static const size_t WITNESS_SETTLE_LIMIT = 500;
+
+private:
+    size_t _size;
+    size_t _shortcuts;
+
+    /* Edges to higher ranked stations out of every station, and
+       edges from higher ranked stations into every station, in
+       runs that start at '_up_first' and '_down_first'. */
+    vector<uint32_t> _up_first;
+    vector<hierarchy_edge_t> _up;
+    vector<uint32_t> _down_first;
+    vector<hierarchy_edge_t> _down;
+
+    /**
+        Search both ways from 'src' and 'dest'. Returns the cost
+        and the station where the searches met, 0 if none. The
+        parents of both searches stay in the per thread scratch.
+    */
+    pair<uint, uint> query( uint src, uint dest ) const;
+
+    /* Append the stations of the edge from 'from' to 'to', but 'from'. */
+    void unpack( uint from, uint to, uint32_t middle, vector<uint>& path ) const;
+
+    /* Cheapest edge of the hierarchy from 'from' to 'to'. */
+    hierarchy_edge_t const* find_edge( uint from, uint to ) const;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "DepthFirstSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+
+using namespace std;
+
+DepthFirstSearch::DepthFirstSearch( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename )
+: SearchEngine { schools, filename }
+, _state { graph, stations, bus, heuristic }
+, _initial_station { bus._current_station }
+, _next_bound { UINT_MAX }
+{
+    _stats._bytes_per_open_node = sizeof(search_op_t);
+    _stats._bytes_per_closed_node = 0;
+}
+
+void DepthFirstSearch::set_transposition_table( size_t bytes, TranspositionTable::replacement_t replacement )
+{
+    _table = TranspositionTable( bytes, replacement );
+    _stats._bytes_per_closed_node = _table.enabled() ? sizeof(tt_entry_t) : 0;
+}
+
+bool DepthFirstSearch::solve()
+{
+    auto start = std::chrono::steady_clock::now();
+    _solved = false;
+    _status = search_status_t::EXHAUSTED;
+
+    uint bound = _state.heuristic();
+    outcome_t outcome = outcome_t::NOT_FOUND;
+    if (_verbose)
+        cout << "Search started" << endl;
+    while ( true ) {
+        _next_bound = UINT_MAX;
+        uint lowest = UINT_MAX;
+        uint64_t expansions = _stats._number_of_expansions;
+        _table.new_iteration();
+        outcome = search( 0, bound, lowest );
+        if (_verbose)
+            cout << "Bound " << bound << ": " << _stats._number_of_expansions - expansions
+                 << " expansions" << endl;
+        if ( outcome != outcome_t::NOT_FOUND || _next_bound == UINT_MAX )
+            break;
+        bound = _next_bound;
+    }
+    _stats._tt_probes = _table.probes();
+    _stats._tt_hits = _table.hits();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    _stats._elapsed_seconds = elapsed.count();
+    _stats._timeline.push_back( make_pair( _stats._elapsed_seconds, _stats._number_of_expansions ) );
+    _stats._peak_memory_estimate = _operators.size() * sizeof(vector<search_op_t>)
+        + _stats._peak_open * sizeof(search_op_t) + _table.size_in_bytes();
+
+    if ( outcome == outcome_t::FOUND ) {
+        _solved = true;
+        _status = search_status_t::SOLVED;
+        _solution = recover();
+    }
+    else if (_verbose) {
+        if (_status == search_status_t::DEADLINE)
+            cout << endl << "Deadline reached." << endl;
+        else if (_status == search_status_t::INTERRUPTED)
+            cout << endl << "Interrupted." << endl;
+        else
+            cout << endl << "No solution could be found." << endl;
+    }
+    return _solved;
+}
+
+DepthFirstSearch::outcome_t DepthFirstSearch::search( uint g, uint bound, uint& lowest )
+{
+    ++_stats._heuristic_evaluations;
+    uint h = _state.heuristic();
+    if ( _table.enabled() ) {
+        tt_entry_t* entry = _table.probe( _state.hash() );
+        if ( entry ) {
+            // Reached as cheaply in this iteration: its subtree was, or
+            // is being, searched already. What was pruned there went
+            // into '_next_bound' then.
+            if ( entry->_age == _table.age() && entry->_g <= g ) {
+                ++_stats._tt_cutoffs;
+                lowest = std::min( lowest, g + entry->_h );
+                return outcome_t::NOT_FOUND;
+            }
+            h = std::max<uint>( h, entry->_h );
+        }
+    }
+
+    uint f = g + h;
+    if ( f > bound ) {
+        _next_bound = std::min( _next_bound, f );
+        lowest = std::min( lowest, f );
+        return outcome_t::NOT_FOUND;
+    }
+    if ( _state.is_final() ) {
+        _stats._solution_cost = g;
+        return outcome_t::FOUND;
+    }
+    if ( deadline_passed() ) {
+        _status = search_status_t::DEADLINE;
+        return outcome_t::STOPPED;
+    }
+    if ( _stop_requested ) {
+        _status = search_status_t::INTERRUPTED;
+        return outcome_t::STOPPED;
+    }
+
+    ++_stats._number_of_expansions;
+    size_t depth = _path.size();
+    if ( _table.enabled() )
+        _table.store( _state.hash(), g, h, depth );
+    if ( _operators.size() <= depth )
+        _operators.emplace_back();
+    _state.operators( _operators[depth] );
+
+    uint subtree_lowest = UINT_MAX;
+    // Whether an operator was left out because of the path here.
+    bool skipped_back = false;
+    // Deeper calls may grow '_operators', so index it every time.
+    for ( size_t i=0; i<_operators[depth].size(); ++i ) {
+        search_op_t op = _operators[depth][i];
+        // Going straight back costs more than not leaving.
+        if ( op._kind == search_op_t::TRANSIT && !_path.empty()
+            && _path.back()._kind == search_op_t::TRANSIT && _path.back()._from == op._to ) {
+            skipped_back = true;
+            continue;
+        }
+
+        ++_stats._generated;
+        _state.apply( op );
+        _path.push_back( op );
+        _stats._peak_open = std::max<uint64_t>( _stats._peak_open, _path.size() );
+        outcome_t outcome = search( g + op._cost, bound, subtree_lowest );
+        if ( outcome == outcome_t::FOUND )
+            return outcome;
+        _path.pop_back();
+        _state.undo( op );
+        if ( outcome == outcome_t::STOPPED )
+            return outcome;
+    }
+
+    // Nothing under this state is final with f up to 'bound': its
+    // cost to go is at least what was pruned under it. Unless an
+    // operator was skipped, as another path to the state may take
+    // it: the entry then keeps plain 'h'.
+    if ( _table.enabled() && subtree_lowest != UINT_MAX && !skipped_back )
+        _table.store( _state.hash(), g, std::max( h, subtree_lowest - g ), depth );
+    lowest = std::min( lowest, subtree_lowest );
+    return outcome_t::NOT_FOUND;
+}
+
+string DepthFirstSearch::recover()
+{
+    vector<expanded_t> ordered_recovery;
+    for ( auto op = _path.rbegin(); op != _path.rend(); ++op ) {
+        ordered_recovery.push_back( expanded_t (
+            0, 0,
+            op->_to,
+            op->_kind == search_op_t::EMBARK,
+            op->_kind == search_op_t::DISEMBARK,
+            op->_kind == search_op_t::EMBARK ? _state.destination(op->_from) : 0 ) );
+    }
+    ordered_recovery.push_back( expanded_t(0, 0, _initial_station, false, false, 0) );
+    return format_route( ordered_recovery );
+}
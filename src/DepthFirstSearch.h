@@ -0,0 +1,69 @@
+#ifndef DEPTHFIRSTSEARCH_H
+#define DEPTHFIRSTSEARCH_H
+
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "SearchEngine.h"
+#include "SearchState.h"
+#include "TranspositionTable.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    IDA*: depth-first searches bounded by f, the bound growing to
+    the lowest f pruned by the previous one until a solution is
+    found. The first solution found is optimal.
+
+    A single SearchState is changed in place with apply and undo,
+    so memory is the path and one operator buffer per depth. It
+    never moves straight back to the station just left.
+
+    With a transposition table, a configuration already reached as
+    cheaply in the same iteration is not searched again, and the
+    table keeps, across iterations, the heuristic of a configuration
+    raised to the lowest f pruned under it. Without one, no other
+    duplicates are detected.
+*/
+class DepthFirstSearch : public SearchEngine
+{
+public:
+    /**
+        Same arguments as Solver.
+    */
+    DepthFirstSearch( Graph const * graph, vector<school_t> schools,
+        vector<station_t>& stations, bus_t& bus,
+        heuristic_t heuristic, string filename );
+
+    bool solve() override;
+
+    /* Use a transposition table of at most 'bytes', none if zero. */
+    void set_transposition_table( size_t bytes, TranspositionTable::replacement_t replacement );
+
+private:
+    enum class outcome_t { FOUND, NOT_FOUND, STOPPED };
+
+    SearchState _state;
+    uint _initial_station;
+
+    /* Operators from the initial state to the current one. */
+    vector<search_op_t> _path;
+    /* Operators of the state at every depth of the path. */
+    vector< vector<search_op_t> > _operators;
+
+    TranspositionTable _table;
+    /* Lowest f over the bound of the current iteration. */
+    uint _next_bound;
+
+    /**
+        Search under the state reached with cost 'g' for a final
+        state with f up to 'bound'. 'lowest' receives the lowest
+        f pruned under it, by the bound or by the table.
+    */
+    outcome_t search( uint g, uint bound, uint& lowest );
+
+    string recover();
+};
+
+#endif
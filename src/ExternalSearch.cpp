@@ -0,0 +1,765 @@
+#include "ExternalSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+/* Action that produced a record, as in expanded_t. */
+const uint8_t ACTION_TRANSIT    = 0;
+const uint8_t ACTION_EMBARK     = 1;
+const uint8_t ACTION_DISEMBARK  = 2;
+const uint8_t ACTION_ROOT       = 4;
+
+const char* MANIFEST_HEADER = "external-search 1";
+
+/**
+    Field offsets of a record for keys of 'key_size' bytes.
+*/
+struct record_layout_t
+{
+    size_t _key_size;
+
+    size_t g() const       { return _key_size; }
+    size_t parent() const  { return _key_size + sizeof(uint32_t); }
+    size_t action() const  { return 2 * _key_size + sizeof(uint32_t); }
+    size_t school() const  { return 2 * _key_size + sizeof(uint32_t) + 1; }
+    size_t size() const    { return 2 * _key_size + 2 * sizeof(uint32_t) + 1; }
+};
+
+uint32_t read_u32( const uint8_t* at )
+{
+    uint32_t value;
+    memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+void write_u32( uint8_t* at, uint32_t value )
+{
+    memcpy(at, &value, sizeof(value));
+}
+
+/**
+    Buffered sequential writer of fixed size records.
+*/
+class record_writer
+{
+public:
+    record_writer( const string& path, uint64_t& bytes_written )
+    : _file { fopen(path.c_str(), "wb") }
+    , _path { path }
+    , _bytes_written { bytes_written }
+    , _records { 0 }
+    {
+        if ( !_file )
+            throw runtime_error( "cannot create " + path );
+        setvbuf(_file, nullptr, _IOFBF, ExternalSearch::IO_BUFFER_SIZE);
+    }
+
+    void write( const uint8_t* record, size_t size )
+    {
+        if ( fwrite(record, 1, size, _file) != size )
+            throw runtime_error( "cannot write " + _path );
+        _bytes_written += size;
+        ++_records;
+    }
+
+    uint64_t records() const { return _records; }
+
+    void close()
+    {
+        if ( _file && fclose(_file) != 0 )
+            throw runtime_error( "cannot write " + _path );
+        _file = nullptr;
+    }
+
+    ~record_writer()
+    {
+        if ( _file )
+            fclose(_file);
+    }
+
+private:
+    FILE* _file;
+    string _path;
+    uint64_t& _bytes_written;
+    uint64_t _records;
+};
+
+/**
+    Buffered sequential reader of fixed size records.
+*/
+class record_reader
+{
+public:
+    record_reader( const string& path, size_t record_size, uint64_t& bytes_read )
+    : _fd { open(path.c_str(), O_RDONLY) }
+    , _path { path }
+    , _record_size { record_size }
+    , _buffer ( max<size_t>(1, ExternalSearch::IO_BUFFER_SIZE / record_size) * record_size )
+    , _filled { 0 }
+    , _offset { 0 }
+    , _bytes_read { bytes_read }
+    {
+        if ( _fd < 0 )
+            throw runtime_error( "cannot open " + path );
+        posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        fill();
+    }
+
+    bool valid() const { return _offset < _filled; }
+
+    const uint8_t* current() const { return _buffer.data() + _offset; }
+
+    void next()
+    {
+        _offset += _record_size;
+        if ( _offset >= _filled )
+            fill();
+    }
+
+    ~record_reader() { close(_fd); }
+
+private:
+    void fill()
+    {
+        _filled = 0;
+        _offset = 0;
+        while ( _filled < _buffer.size() ) {
+            ssize_t n = read(_fd, _buffer.data() + _filled, _buffer.size() - _filled);
+            if ( n < 0 )
+                throw runtime_error( "cannot read " + _path );
+            if ( n == 0 )
+                break;
+            _filled += static_cast<size_t>(n);
+        }
+        _bytes_read += _filled;
+        _filled -= _filled % _record_size;
+    }
+
+    int _fd;
+    string _path;
+    size_t _record_size;
+    vector<uint8_t> _buffer;
+    size_t _filled;
+    size_t _offset;
+    uint64_t& _bytes_read;
+};
+
+/**
+    Order of records: by key, then by g.
+*/
+int compare_records( const uint8_t* a, const uint8_t* b, const record_layout_t& layout )
+{
+    int order = memcmp(a, b, layout._key_size);
+    if ( order != 0 )
+        return order;
+    uint32_t ga = read_u32(a + layout.g());
+    uint32_t gb = read_u32(b + layout.g());
+    return ga < gb ? -1 : (ga > gb ? 1 : 0);
+}
+
+string to_hex( const uint8_t* data, size_t size )
+{
+    static const char* digits = "0123456789abcdef";
+    string hex;
+    for ( size_t i=0; i<size; ++i ) {
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 0xf];
+    }
+    return hex;
+}
+
+bool is_search_file( const string& name )
+{
+    return name.rfind("open-", 0) == 0 || name.rfind("closed-", 0) == 0
+        || name.rfind("sort-", 0) == 0 || name == "manifest.tmp";
+}
+
+} // namespace
+
+
+ExternalSearch::ExternalSearch( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename,
+    string work_dir, size_t sort_memory )
+: SearchEngine { schools, filename }
+, _graph { graph }
+, _stations { stations }
+, _bus { bus }
+, _heuristic { heuristic }
+, _layout { stations, bus }
+, _work_dir { work_dir }
+, _sort_memory { sort_memory }
+{
+    _key_size = _layout.key_size();
+    _record_size = record_layout_t { _key_size }.size();
+    _stats._bytes_per_open_node = _record_size;
+    _stats._bytes_per_closed_node = _record_size;
+}
+
+void ExternalSearch::set_resume( bool resume ) { _resume = resume; }
+
+bool ExternalSearch::solve()
+{
+    auto start_time = std::chrono::steady_clock::now();
+    _solved = false;
+    _status = search_status_t::EXHAUSTED;
+
+    if ( _resume && read_manifest() ) {
+        if (_verbose)
+            cout << "Resuming search from " << manifest_path() << endl;
+        remove_stray_files();
+    }
+    else {
+        _open_layers.clear();
+        _open_counts.clear();
+        _closed_runs.clear();
+        _closed_count = 0;
+        remove_stray_files();
+        start();
+        write_manifest();
+    }
+
+    vector<uint8_t> goal;
+    while ( !_open_layers.empty() && !_solved ) {
+        uint f = _open_layers.begin()->first;
+        vector<string> consumed = _open_layers.begin()->second;
+
+        string sorted = sort_layer( consumed );
+        string fresh = subtract_closed( sorted );
+
+        map< uint, pair<string, uint64_t> > children;
+        _solved = expand( fresh, f, children, goal );
+        if ( _solved || _status != search_status_t::EXHAUSTED ) {
+            // Leave the manifest of the last finished round.
+            remove_file( fresh );
+            for ( auto const& child : children )
+                remove_file( child.second.first );
+            break;
+        }
+
+        /* The layer is replaced by the successors that fell back into it. */
+        _open_layers.erase( f );
+        _open_counts.erase( f );
+        for ( auto const& child : children ) {
+            if ( child.second.second == 0 ) {
+                remove_file( child.second.first );
+                continue;
+            }
+            _open_layers[child.first].push_back( child.second.first );
+            _open_counts[child.first] += child.second.second;
+        }
+        _closed_runs.push_back( fresh );
+
+        vector<string> previous_runs = _closed_runs;
+        if ( _closed_runs.size() > MAX_CLOSED_RUNS )
+            merge_closed_runs();
+        write_manifest();
+
+        for ( const string& file : consumed )
+            remove_file( file );
+        if ( _closed_runs.size() == 1 && previous_runs.size() > 1 ) {
+            for ( const string& file : previous_runs )
+                remove_file( file );
+        }
+
+        uint64_t open = 0;
+        for ( auto const& layer : _open_counts )
+            open += layer.second;
+        _stats._peak_open = std::max(_stats._peak_open, open);
+        _stats._peak_closed = std::max(_stats._peak_closed, _closed_count);
+        _stats._peak_memory_estimate = std::max(_stats._peak_memory_estimate,
+            (open + _closed_count) * _record_size);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    _stats._elapsed_seconds = elapsed.count();
+    _stats._timeline.push_back(make_pair(_stats._elapsed_seconds, _stats._number_of_expansions));
+
+    if ( _solved ) {
+        _status = search_status_t::SOLVED;
+        _stats._solution_cost = read_u32( goal.data() + record_layout_t { _key_size }.g() );
+        _solution = recover_solution( goal );
+
+        _open_layers.clear();
+        _closed_runs.clear();
+        remove_stray_files();
+        unlink( manifest_path().c_str() );
+    }
+    else if (_verbose) {
+        if (_status == search_status_t::DEADLINE)
+            cout << endl << "Deadline reached." << endl;
+        else if (_status == search_status_t::INTERRUPTED)
+            cout << endl << "Interrupted, resume with --resume." << endl;
+        else
+            cout << endl << "No solution could be found." << endl;
+    }
+    return _solved;
+}
+
+void ExternalSearch::start()
+{
+    record_layout_t layout { _key_size };
+    state_t initial ( _graph, _stations, _bus, _heuristic );
+    vector<uint8_t> record ( _record_size, 0 );
+    _layout.pack( initial, record.data() );
+    write_u32( record.data() + layout.g(), 0 );
+    record[layout.action()] = ACTION_ROOT;
+
+    uint f = initial.get_heuristic_cost();
+    ++_stats._heuristic_evaluations;
+    string file = new_file( "open-" );
+    record_writer writer { path_of(file), _stats._bytes_written };
+    writer.write( record.data(), _record_size );
+    writer.close();
+    _open_layers[f].push_back( file );
+    _open_counts[f] = 1;
+}
+
+string ExternalSearch::sort_layer( vector<string> const& files )
+{
+    record_layout_t layout { _key_size };
+    size_t capacity = std::max<size_t>(1, _sort_memory / (_record_size + sizeof(uint32_t)));
+    vector<uint8_t> buffer;
+    vector<uint32_t> order;
+    vector<string> runs;
+
+    auto flush = [&]() {
+        size_t count = buffer.size() / _record_size;
+        order.resize( count );
+        for ( size_t i=0; i<count; ++i )
+            order[i] = static_cast<uint32_t>(i);
+        sort( order.begin(), order.end(), [&]( uint32_t a, uint32_t b ) {
+            return compare_records( buffer.data() + a * _record_size,
+                buffer.data() + b * _record_size, layout ) < 0;
+        });
+
+        string run = new_file( "sort-" );
+        record_writer writer { path_of(run), _stats._bytes_written };
+        const uint8_t* previous = nullptr;
+        for ( uint32_t i : order ) {
+            const uint8_t* record = buffer.data() + i * _record_size;
+            // The first record of every key has the lowest g.
+            if ( previous && memcmp(previous, record, _key_size) == 0 )
+                continue;
+            writer.write( record, _record_size );
+            previous = record;
+        }
+        writer.close();
+        runs.push_back( run );
+        buffer.clear();
+    };
+
+    for ( const string& file : files ) {
+        for ( record_reader reader { path_of(file), _record_size, _stats._bytes_read };
+            reader.valid(); reader.next() ) {
+            buffer.insert( buffer.end(), reader.current(), reader.current() + _record_size );
+            if ( buffer.size() / _record_size == capacity )
+                flush();
+        }
+    }
+    if ( !buffer.empty() || runs.empty() )
+        flush();
+
+    return merge_runs( runs, true );
+}
+
+string ExternalSearch::merge_runs( vector<string> runs, bool remove_inputs )
+{
+    set<string> inputs { runs.begin(), runs.end() };
+    record_layout_t layout { _key_size };
+    size_t fan_in = std::max<size_t>(2, _sort_memory / IO_BUFFER_SIZE);
+
+    while ( runs.size() > 1 ) {
+        vector<string> merged;
+        for ( size_t first = 0; first < runs.size(); first += fan_in ) {
+            size_t last = std::min(runs.size(), first + fan_in);
+            if ( last - first == 1 ) {
+                merged.push_back( runs[first] );
+                continue;
+            }
+
+            vector< unique_ptr<record_reader> > readers;
+            for ( size_t i = first; i < last; ++i )
+                readers.push_back( unique_ptr<record_reader>(
+                    new record_reader( path_of(runs[i]), _record_size, _stats._bytes_read ) ) );
+
+            auto later = [&]( size_t a, size_t b ) {
+                return compare_records( readers[a]->current(), readers[b]->current(), layout ) > 0;
+            };
+            priority_queue< size_t, vector<size_t>, decltype(later) > heads ( later );
+            for ( size_t i=0; i<readers.size(); ++i ) {
+                if ( readers[i]->valid() )
+                    heads.push( i );
+            }
+
+            string output = new_file( "sort-" );
+            record_writer writer { path_of(output), _stats._bytes_written };
+            vector<uint8_t> previous;
+            while ( !heads.empty() ) {
+                size_t i = heads.top();
+                heads.pop();
+                const uint8_t* record = readers[i]->current();
+                if ( previous.empty() || memcmp(previous.data(), record, _key_size) != 0 ) {
+                    writer.write( record, _record_size );
+                    previous.assign( record, record + _record_size );
+                }
+                readers[i]->next();
+                if ( readers[i]->valid() )
+                    heads.push( i );
+            }
+            writer.close();
+            readers.clear();
+
+            for ( size_t i = first; i < last; ++i ) {
+                if ( remove_inputs || inputs.count(runs[i]) == 0 )
+                    remove_file( runs[i] );
+            }
+            merged.push_back( output );
+        }
+        runs.swap( merged );
+    }
+    return runs.front();
+}
+
+string ExternalSearch::subtract_closed( string const& sorted )
+{
+    record_layout_t layout { _key_size };
+    vector< unique_ptr<record_reader> > closed;
+    for ( const string& run : _closed_runs )
+        closed.push_back( unique_ptr<record_reader>(
+            new record_reader( path_of(run), _record_size, _stats._bytes_read ) ) );
+
+    string fresh = new_file( "closed-" );
+    record_writer writer { path_of(fresh), _stats._bytes_written };
+    for ( record_reader reader { path_of(sorted), _record_size, _stats._bytes_read };
+        reader.valid(); reader.next() ) {
+        const uint8_t* record = reader.current();
+        uint32_t g = read_u32( record + layout.g() );
+
+        bool seen = false, pruned = false;
+        for ( auto& run : closed ) {
+            while ( run->valid() && memcmp(run->current(), record, _key_size) < 0 )
+                run->next();
+            if ( run->valid() && memcmp(run->current(), record, _key_size) == 0 ) {
+                seen = true;
+                if ( read_u32( run->current() + layout.g() ) <= g )
+                    pruned = true;
+            }
+        }
+
+        if ( pruned ) {
+            ++_stats._duplicates_pruned;
+            continue;
+        }
+        if ( seen )
+            ++_stats._reopened;
+        writer.write( record, _record_size );
+    }
+    writer.close();
+    closed.clear();
+    remove_file( sorted );
+    return fresh;
+}
+
+bool ExternalSearch::expand( string const& fresh, uint f,
+    map< uint, pair<string, uint64_t> >& children, vector<uint8_t>& goal )
+{
+    record_layout_t layout { _key_size };
+    map< uint, unique_ptr<record_writer> > writers;
+    vector<uint8_t> child ( _record_size, 0 );
+    uint64_t expanded = 0;
+    bool found = false;
+
+    for ( record_reader reader { path_of(fresh), _record_size, _stats._bytes_read };
+        reader.valid(); reader.next() ) {
+        const uint8_t* record = reader.current();
+        if ( _layout.is_final( record ) ) {
+            goal.assign( record, record + _record_size );
+            found = true;
+            break;
+        }
+        if ( deadline_passed() ) {
+            _status = search_status_t::DEADLINE;
+            break;
+        }
+        if ( _stop_requested ) {
+            _status = search_status_t::INTERRUPTED;
+            break;
+        }
+
+        uint32_t g = read_u32( record + layout.g() );
+        state_t state = _layout.unpack( record, _graph, _heuristic, g, expanded_t() );
+        vector<state_t> successors = state.get_successors();
+        ++_stats._number_of_expansions;
+        ++expanded;
+        _stats._generated += successors.size();
+
+        for ( state_t const& successor : successors ) {
+            _layout.pack( successor, child.data() );
+            uint32_t child_g = successor.get_transition_cost();
+            write_u32( child.data() + layout.g(), child_g );
+            memcpy( child.data() + layout.parent(), record, _key_size );
+
+            expanded_t expansion = successor.get_expansion();
+            child[layout.action()] = expansion._embarking ? ACTION_EMBARK
+                : (expansion._disembarking ? ACTION_DISEMBARK : ACTION_TRANSIT);
+            write_u32( child.data() + layout.school(), expansion._school_destination );
+
+            uint child_f = std::max<uint>( f, child_g + successor.get_heuristic_cost() );
+            ++_stats._heuristic_evaluations;
+
+            auto writer = writers.find( child_f );
+            if ( writer == writers.end() ) {
+                string file = new_file( "open-" );
+                children[child_f] = make_pair( file, 0 );
+                writer = writers.emplace( child_f, unique_ptr<record_writer>(
+                    new record_writer( path_of(file), _stats._bytes_written ) ) ).first;
+            }
+            writer->second->write( child.data(), _record_size );
+        }
+    }
+
+    for ( auto& writer : writers ) {
+        writer.second->close();
+        children[writer.first].second = writer.second->records();
+    }
+    _closed_count += expanded;
+
+    if (_verbose)
+        cout << "f=" << f << ": " << expanded << " expanded, "
+             << _stats._number_of_expansions << " in total" << endl;
+    return found;
+}
+
+void ExternalSearch::merge_closed_runs()
+{
+    // The old runs stay listed in the manifest until it is rewritten.
+    string merged = merge_runs( _closed_runs, false );
+    string run = new_file( "closed-" );
+    if ( rename( path_of(merged).c_str(), path_of(run).c_str() ) != 0 )
+        throw runtime_error( "cannot write " + path_of(run) );
+    _closed_runs = vector<string> { run };
+
+    struct stat info;
+    if ( stat( path_of(run).c_str(), &info ) == 0 )
+        _closed_count = static_cast<uint64_t>(info.st_size) / _record_size;
+}
+
+bool ExternalSearch::find_closed( const uint8_t* key, vector<uint8_t>& record )
+{
+    record_layout_t layout { _key_size };
+    vector<uint8_t> probe ( _record_size );
+    bool found = false;
+
+    for ( const string& run : _closed_runs ) {
+        int fd = open( path_of(run).c_str(), O_RDONLY );
+        if ( fd < 0 )
+            throw runtime_error( "cannot open " + path_of(run) );
+        struct stat info;
+        fstat(fd, &info);
+
+        // Lower bound of 'key' among the records of the run.
+        uint64_t low = 0, high = static_cast<uint64_t>(info.st_size) / _record_size;
+        while ( low < high ) {
+            uint64_t middle = low + (high - low) / 2;
+            if ( pread(fd, probe.data(), _record_size, middle * _record_size)
+                != static_cast<ssize_t>(_record_size) )
+                throw runtime_error( "cannot read " + path_of(run) );
+            _stats._bytes_read += _record_size;
+            if ( memcmp(probe.data(), key, _key_size) < 0 )
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        if ( pread(fd, probe.data(), _record_size, low * _record_size)
+            == static_cast<ssize_t>(_record_size)
+            && memcmp(probe.data(), key, _key_size) == 0 ) {
+            _stats._bytes_read += _record_size;
+            if ( !found || read_u32(probe.data() + layout.g()) < read_u32(record.data() + layout.g()) )
+                record = probe;
+            found = true;
+        }
+        close(fd);
+    }
+    return found;
+}
+
+/**
+    Follow parent keys from the goal back to the initial state.
+    Every step picks the cheapest closed record of the parent,
+    which is still a path of optimal cost.
+*/
+string ExternalSearch::recover_solution( vector<uint8_t> const& goal )
+{
+    record_layout_t layout { _key_size };
+    vector<expanded_t> ordered_recovery;
+    vector<uint8_t> record = goal;
+
+    if (_verbose)
+        cout << "Recovering solution." << endl;
+    for ( uint64_t steps = 0; ; ++steps ) {
+        uint8_t action = record[layout.action()];
+        ordered_recovery.push_back( expanded_t (
+            0, 0,
+            StateLayout::station_of( record.data() ),
+            action == ACTION_EMBARK,
+            action == ACTION_DISEMBARK,
+            read_u32( record.data() + layout.school() ) ) );
+        if ( action == ACTION_ROOT )
+            break;
+
+        vector<uint8_t> parent_key ( record.begin() + layout.parent(),
+            record.begin() + layout.parent() + _key_size );
+        if ( steps > _closed_count || !find_closed( parent_key.data(), record ) )
+            throw runtime_error( "broken parent chain in " + _work_dir );
+    }
+
+    return format_route( ordered_recovery );
+}
+
+string ExternalSearch::new_file( const string& prefix )
+{
+    return prefix + to_string( _next_file++ ) + ".bin";
+}
+
+string ExternalSearch::path_of( const string& file ) const
+{
+    return _work_dir + "/" + file;
+}
+
+void ExternalSearch::remove_file( const string& file )
+{
+    unlink( path_of(file).c_str() );
+}
+
+string ExternalSearch::manifest_path() const
+{
+    return path_of( "manifest" );
+}
+
+/**
+    Manifest of the work directory, replaced atomically after
+    every finished round:
+
+        external-search 1
+        problem <record size> <initial key in hex> <heuristic>
+        next_file <n>
+        stats <expansions> <generated> <duplicates> <reopened> <read> <written>
+        closed <records> <file> ...
+        open <f> <records> <file> ...
+*/
+void ExternalSearch::write_manifest()
+{
+    vector<uint8_t> key ( _key_size );
+    state_t initial ( _graph, _stations, _bus, _heuristic );
+    _layout.pack( initial, key.data() );
+
+    string temporary = path_of( "manifest.tmp" );
+    {
+        ofstream manifest { temporary };
+        manifest << MANIFEST_HEADER << endl;
+        manifest << "problem " << _record_size << " " << to_hex(key.data(), key.size())
+                 << " " << heuristic_name(_heuristic) << endl;
+        manifest << "next_file " << _next_file << endl;
+        manifest << "stats " << _stats._number_of_expansions << " " << _stats._generated << " "
+                 << _stats._duplicates_pruned << " " << _stats._reopened << " "
+                 << _stats._bytes_read << " " << _stats._bytes_written << endl;
+        manifest << "closed " << _closed_count;
+        for ( const string& run : _closed_runs )
+            manifest << " " << run;
+        manifest << endl;
+        for ( auto const& layer : _open_layers ) {
+            manifest << "open " << layer.first << " " << _open_counts[layer.first];
+            for ( const string& file : layer.second )
+                manifest << " " << file;
+            manifest << endl;
+        }
+        if ( !manifest.flush() )
+            throw runtime_error( "cannot write " + temporary );
+    }
+    if ( rename( temporary.c_str(), manifest_path().c_str() ) != 0 )
+        throw runtime_error( "cannot write " + manifest_path() );
+}
+
+bool ExternalSearch::read_manifest()
+{
+    ifstream manifest { manifest_path() };
+    string line;
+    if ( !manifest || !getline(manifest, line) || line != MANIFEST_HEADER )
+        return false;
+
+    vector<uint8_t> key ( _key_size );
+    state_t initial ( _graph, _stations, _bus, _heuristic );
+    _layout.pack( initial, key.data() );
+    ostringstream expected;
+    expected << "problem " << _record_size << " " << to_hex(key.data(), key.size())
+             << " " << heuristic_name(_heuristic);
+    if ( !getline(manifest, line) || line != expected.str() )
+        throw runtime_error( manifest_path() + " belongs to another problem or heuristic" );
+
+    _open_layers.clear();
+    _open_counts.clear();
+    _closed_runs.clear();
+    while ( getline(manifest, line) ) {
+        istringstream fields { line };
+        string kind, file;
+        fields >> kind;
+        if ( kind == "next_file" )
+            fields >> _next_file;
+        else if ( kind == "stats" )
+            fields >> _stats._number_of_expansions >> _stats._generated
+                   >> _stats._duplicates_pruned >> _stats._reopened
+                   >> _stats._bytes_read >> _stats._bytes_written;
+        else if ( kind == "closed" ) {
+            fields >> _closed_count;
+            while ( fields >> file )
+                _closed_runs.push_back( file );
+        }
+        else if ( kind == "open" ) {
+            uint f;
+            uint64_t records;
+            fields >> f >> records;
+            _open_counts[f] = records;
+            while ( fields >> file )
+                _open_layers[f].push_back( file );
+        }
+    }
+    return true;
+}
+
+void ExternalSearch::remove_stray_files()
+{
+    set<string> listed { _closed_runs.begin(), _closed_runs.end() };
+    for ( auto const& layer : _open_layers )
+        listed.insert( layer.second.begin(), layer.second.end() );
+
+    DIR* directory = opendir( _work_dir.c_str() );
+    if ( !directory )
+        throw runtime_error( "cannot open work directory " + _work_dir );
+    vector<string> stray;
+    while ( dirent* entry = readdir(directory) ) {
+        string name = entry->d_name;
+        if ( is_search_file(name) && listed.count(name) == 0 )
+            stray.push_back( name );
+    }
+    closedir( directory );
+
+    for ( const string& name : stray )
+        remove_file( name );
+}
@@ -0,0 +1,144 @@
+#ifndef EXTERNALSEARCH_H
+#define EXTERNALSEARCH_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "PackedState.h"
+#include "SearchEngine.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    External memory A*. Open and closed lists live on disk as
+    files of fixed size records:
+
+        [key] [g u32] [parent key] [action u8] [school station u32]
+
+    where keys are StateLayout configurations, so two paths to
+    the same configuration produce the same key.
+
+    The open list is split into layers by f. A layer is expanded
+    in rounds: its files are sorted by key with a bounded amount
+    of RAM, duplicates are dropped keeping the cheapest record,
+    and the result is merged against the closed runs, which are
+    sorted by key as well. What survives is expanded in one
+    sequential pass, appending successors to the layer files of
+    their f, and becomes a new closed run. Successors whose f is
+    lower than the layer being expanded go back into it, so the
+    f values of a path never decrease.
+
+    All reads and writes during the search are sequential. The
+    layer files and closed runs of every finished round are
+    listed in a manifest, so a search that was interrupted can be
+    resumed from the last finished round.
+*/
+class ExternalSearch : public SearchEngine
+{
+public:
+    /**
+        Same problem arguments as Solver. Files are kept in
+        'work_dir', which must exist, and sorting uses at most
+        'sort_memory' bytes of records at a time.
+    */
+    ExternalSearch( Graph const * graph, vector<school_t> schools,
+        vector<station_t>& stations, bus_t& bus,
+        heuristic_t heuristic, string filename,
+        string work_dir, size_t sort_memory );
+
+    bool solve() override;
+
+    /**
+        Continue from the manifest of 'work_dir' instead of
+        starting over, if there is one.
+    */
+    void set_resume( bool resume );
+
+    /* Runs of closed records merged into one once there are more. */
+    static const size_t MAX_CLOSED_RUNS = 16;
+
+    /* Buffer of every sequential reader and writer. */
+    static const size_t IO_BUFFER_SIZE = 256 * 1024;
+
+    static const size_t DEFAULT_SORT_MEMORY = 256 * 1024 * 1024;
+
+private:
+    Graph const* _graph;
+    vector<station_t> _stations;
+    bus_t _bus;
+    heuristic_t _heuristic;
+    StateLayout _layout;
+
+    string _work_dir;
+    size_t _sort_memory;
+    bool _resume                = false;
+
+    size_t _key_size;
+    size_t _record_size;
+
+    /* f -> files holding the records of the layer. */
+    map< uint, vector<string> > _open_layers;
+    /* Records waiting in every layer. */
+    map< uint, uint64_t > _open_counts;
+    vector<string> _closed_runs;
+    uint64_t _closed_count      = 0;
+    uint64_t _next_file         = 0;
+
+    string new_file( const string& prefix );
+    string path_of( const string& file ) const;
+    void remove_file( const string& file );
+
+    /* Record of the initial state, in its layer. */
+    void start();
+
+    /**
+        Sort the records of 'files' by key and drop duplicates,
+        keeping the lowest g. Returns the sorted file.
+    */
+    string sort_layer( vector<string> const& files );
+
+    /**
+        Merge files sorted by key into one, keeping the lowest g
+        of every key. At most 'sort_memory' bytes of read buffers
+        are open at once, so many files take several passes.
+        The given files are deleted if 'remove_inputs' is set.
+    */
+    string merge_runs( vector<string> runs, bool remove_inputs );
+
+    /**
+        Drop the records of 'sorted' that are already closed
+        with the same or lower g. Returns the surviving ones.
+    */
+    string subtract_closed( string const& sorted );
+
+    /**
+        Expand every record of 'fresh', appending successors to
+        new layer files, returned in 'children' with their record
+        counts. Returns true and fills 'goal' if a final state is
+        found.
+    */
+    bool expand( string const& fresh, uint f, map< uint, pair<string, uint64_t> >& children,
+        vector<uint8_t>& goal );
+
+    void merge_closed_runs();
+
+    /**
+        Look 'key' up in the closed runs and copy its cheapest
+        record into 'record'.
+    */
+    bool find_closed( const uint8_t* key, vector<uint8_t>& record );
+
+    string recover_solution( vector<uint8_t> const& goal );
+
+    string manifest_path() const;
+    void write_manifest();
+    bool read_manifest();
+
+    /* Delete files of the work directory the manifest does not list. */
+    void remove_stray_files();
+};
+
+#endif
@@ -0,0 +1,280 @@
+#include "FrontierSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+FrontierSearch::FrontierSearch( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename )
+: SearchEngine { schools, filename }
+, _graph { graph }
+, _stations { stations }
+, _bus { bus }
+, _heuristic { heuristic }
+, _layout { stations, bus }
+{
+    for ( vector<Transition> const& transitions : graph->transitions ) {
+        for ( Transition const& transition : transitions ) {
+            if ( transition.cost == 0 )
+                throw runtime_error( "frontier search needs every edge to have a positive cost" );
+        }
+    }
+    _bytes_per_node = sizeof(frontier_node_t) + 3 * _layout.key_size() + NODE_OVERHEAD;
+    _stats._bytes_per_open_node = _bytes_per_node;
+    _stats._bytes_per_closed_node = _bytes_per_node;
+}
+
+bool FrontierSearch::solve()
+{
+    auto start_time = std::chrono::steady_clock::now();
+    _solved = false;
+    _status = search_status_t::EXHAUSTED;
+
+    state_t initial ( _graph, _stations, _bus, _heuristic );
+    path_step_t start { pack(initial), 0 };
+    uint bound = initial.get_heuristic_cost();
+    ++_stats._heuristic_evaluations;
+
+    vector< pair<string, frontier_node_t> > path;
+    outcome_t outcome = outcome_t::FOUND;
+    if ( !initial.is_final() ) {
+        pair<string, frontier_node_t> goal;
+        if (_verbose)
+            cout << "Search started" << endl;
+        while ( true ) {
+            uint next_bound = UINT_MAX;
+            uint64_t expansions = _stats._number_of_expansions;
+            outcome = search( start, "", bound, bound, goal, next_bound );
+            if (_verbose)
+                cout << "Bound " << bound << ": " << _stats._number_of_expansions - expansions
+                     << " expansions" << endl;
+            if ( outcome != outcome_t::NOT_FOUND || next_bound == UINT_MAX )
+                break;
+            bound = std::max( next_bound, static_cast<uint>(bound * BOUND_GROWTH) );
+        }
+
+        if ( outcome == outcome_t::FOUND ) {
+            _optimal_cost = goal.second._g;
+            if (_verbose)
+                cout << "Recovering solution." << endl;
+            outcome = recover( start, goal, path );
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    _stats._elapsed_seconds = elapsed.count();
+    _stats._timeline.push_back(make_pair(_stats._elapsed_seconds, _stats._number_of_expansions));
+
+    if ( outcome == outcome_t::FOUND ) {
+        _solved = true;
+        _status = search_status_t::SOLVED;
+        _stats._solution_cost = _optimal_cost;
+
+        vector<expanded_t> ordered_recovery;
+        for ( auto step = path.rbegin(); step != path.rend(); ++step ) {
+            ordered_recovery.push_back( expanded_t (
+                0, 0,
+                StateLayout::station_of( reinterpret_cast<const uint8_t*>(step->first.data()) ),
+                step->second._embarking,
+                step->second._disembarking,
+                step->second._school ) );
+        }
+        ordered_recovery.push_back( expanded_t(0, 0, _bus._current_station, false, false, 0) );
+        _solution = format_route( ordered_recovery );
+    }
+    else if (_verbose) {
+        if (_status == search_status_t::MEMORY_LIMIT)
+            cout << endl << "Memory limit reached." << endl;
+        else if (_status == search_status_t::DEADLINE)
+            cout << endl << "Deadline reached." << endl;
+        else if (_status == search_status_t::INTERRUPTED)
+            cout << endl << "Interrupted." << endl;
+        else
+            cout << endl << "No solution could be found." << endl;
+    }
+    return _solved;
+}
+
+FrontierSearch::outcome_t FrontierSearch::search( path_step_t const& start, string const& target,
+    uint g_limit, uint f_limit, pair<string, frontier_node_t>& found, uint& next_bound )
+{
+    uint threshold = (start._g + g_limit + 1) / 2;
+    bool found_any = false;
+
+    layer_t previous, current, next;
+    frontier_node_t root;
+    root._g = start._g;
+    current.emplace( start._key, root );
+
+    while ( !current.empty() ) {
+        for ( auto const& entry : current ) {
+            if ( deadline_passed() ) {
+                _status = search_status_t::DEADLINE;
+                return outcome_t::STOPPED;
+            }
+            if ( _stop_requested ) {
+                _status = search_status_t::INTERRUPTED;
+                return outcome_t::STOPPED;
+            }
+
+            frontier_node_t const& node = entry.second;
+            state_t state = _layout.unpack( reinterpret_cast<const uint8_t*>(entry.first.data()),
+                _graph, _heuristic, node._g, expanded_t() );
+            vector<state_t> successors = state.get_successors();
+            ++_stats._number_of_expansions;
+            _stats._generated += successors.size();
+
+            for ( state_t const& successor : successors ) {
+                uint g = successor.get_transition_cost();
+                if ( g > g_limit ) {
+                    next_bound = std::min( next_bound, g );
+                    continue;
+                }
+
+                string key = pack( successor );
+                bool is_goal = target.empty()
+                    ? _layout.is_final( reinterpret_cast<const uint8_t*>(key.data()) )
+                    : key == target;
+                uint f = g + successor.get_heuristic_cost();
+                ++_stats._heuristic_evaluations;
+                if ( f > f_limit ) {
+                    next_bound = std::min( next_bound, f );
+                    continue;
+                }
+
+                frontier_node_t child;
+                child._g = g;
+                child._parent = entry.first;
+                child._parent_g = node._g;
+                if ( !node._relay.empty() ) {
+                    child._relay = node._relay;
+                    child._relay_g = node._relay_g;
+                }
+                else if ( g >= threshold ) {
+                    child._relay = key;
+                    child._relay_g = g;
+                }
+                expanded_t expansion = successor.get_expansion();
+                child._embarking = expansion._embarking;
+                child._disembarking = expansion._disembarking;
+                child._school = expansion._school_destination;
+
+                if ( is_goal ) {
+                    if ( !found_any || g < found.second._g )
+                        found = make_pair( key, child );
+                    found_any = true;
+                    if ( !target.empty() )
+                        return outcome_t::FOUND;
+                    // Only cheaper solutions are worth looking for now.
+                    g_limit = f_limit = g;
+                    continue;
+                }
+
+                auto queued = next.find( key );
+                if ( queued != next.end() ) {
+                    if ( queued->second._g <= g )
+                        ++_stats._duplicates_pruned;
+                    else {
+                        queued->second = child;
+                        ++_stats._stored;
+                    }
+                    continue;
+                }
+                bool reopened = false, duplicate = false;
+                for ( layer_t const* layer : { &previous, &current } ) {
+                    auto seen = layer->find( key );
+                    if ( seen != layer->end() ) {
+                        if ( seen->second._g <= g )
+                            duplicate = true;
+                        else
+                            reopened = true;
+                    }
+                }
+                if ( duplicate ) {
+                    ++_stats._duplicates_pruned;
+                    continue;
+                }
+                if ( reopened )
+                    ++_stats._reopened;
+                next.emplace( key, child );
+                ++_stats._stored;
+            }
+        }
+
+        _stats._peak_open = std::max<uint64_t>( _stats._peak_open, current.size() + next.size() );
+        _stats._peak_closed = std::max<uint64_t>( _stats._peak_closed, previous.size() );
+        size_t memory = estimate_memory_use( previous.size() + current.size() + next.size() );
+        _stats._peak_memory_estimate = std::max( _stats._peak_memory_estimate, memory );
+        if ( _memory_limit != 0 && memory > _memory_limit ) {
+            _status = search_status_t::MEMORY_LIMIT;
+            return outcome_t::STOPPED;
+        }
+
+        previous.swap( current );
+        current.swap( next );
+        next.clear();
+    }
+    return found_any ? outcome_t::FOUND : outcome_t::NOT_FOUND;
+}
+
+/**
+    'to' was found searching from 'from'. Its relay splits the
+    path in two halves that are searched for again, unless 'to'
+    is next to 'from' or is its own relay, in which case the
+    path up to its parent is what is left to recover.
+*/
+FrontierSearch::outcome_t FrontierSearch::recover( path_step_t const& from,
+    pair<string, frontier_node_t> const& to, vector< pair<string, frontier_node_t> >& path )
+{
+    frontier_node_t const& node = to.second;
+    bool from_parent = node._parent == from._key && node._parent_g == from._g;
+
+    if ( node._relay.empty() || node._relay == to.first ) {
+        if ( node._relay.empty() && !from_parent ) {
+            // The search that found 'to' had a higher g limit, look again.
+            return research( from, path_step_t { to.first, node._g }, path );
+        }
+        if ( !from_parent ) {
+            outcome_t outcome = research( from, path_step_t { node._parent, node._parent_g }, path );
+            if ( outcome != outcome_t::FOUND )
+                return outcome;
+        }
+        path.push_back( to );
+        return outcome_t::FOUND;
+    }
+
+    path_step_t relay { node._relay, node._relay_g };
+    outcome_t outcome = research( from, relay, path );
+    if ( outcome != outcome_t::FOUND )
+        return outcome;
+    return research( relay, path_step_t { to.first, node._g }, path );
+}
+
+FrontierSearch::outcome_t FrontierSearch::research( path_step_t const& from,
+    path_step_t const& to, vector< pair<string, frontier_node_t> >& path )
+{
+    pair<string, frontier_node_t> found;
+    uint next_bound = UINT_MAX;
+    outcome_t outcome = search( from, to._key, to._g, _optimal_cost, found, next_bound );
+    if ( outcome == outcome_t::NOT_FOUND )
+        throw runtime_error( "frontier search lost a node of the solution path" );
+    if ( outcome != outcome_t::FOUND )
+        return outcome;
+    return recover( from, found, path );
+}
+
+string FrontierSearch::pack( state_t const& state ) const
+{
+    string key ( _layout.key_size(), '\0' );
+    _layout.pack( state, reinterpret_cast<uint8_t*>(&key[0]) );
+    return key;
+}
+
+size_t FrontierSearch::estimate_memory_use( size_t nodes ) const
+{
+    return nodes * _bytes_per_node;
+}
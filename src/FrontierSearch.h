@@ -0,0 +1,119 @@
+#ifndef FRONTIERSEARCH_H
+#define FRONTIERSEARCH_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+#include "PackedState.h"
+#include "SearchEngine.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    Breadth-first heuristic search with divide and conquer
+    solution recovery. Only the layer being expanded, the next
+    one and the previous one, kept as a boundary to catch most
+    duplicates, are held in memory, so memory follows the width
+    of the frontier instead of the number of expansions.
+
+    States are identified by their StateLayout key. Layers go by
+    number of actions, and every child with g + h over an upper
+    bound is pruned. The bound starts at h of the initial state
+    and grows by BOUND_GROWTH until a pass finds a solution;
+    solutions found along a pass lower it, so the cheapest one
+    found is optimal.
+
+    Nodes do not keep their whole path, only their parent and a
+    relay: the first node of their path whose g reached half of
+    the g limit of the search. Once the goal is found, the path
+    is rebuilt by searching again from the start to the relay
+    and from the relay to the goal, recursively.
+
+    Operators must have a positive cost, which bounds the number
+    of layers by the g limit.
+*/
+class FrontierSearch : public SearchEngine
+{
+public:
+    /**
+        Same arguments as Solver. Throws runtime_error if the
+        map has zero cost edges.
+    */
+    FrontierSearch( Graph const * graph, vector<school_t> schools,
+        vector<station_t>& stations, bus_t& bus,
+        heuristic_t heuristic, string filename );
+
+    bool solve() override;
+
+    static constexpr double BOUND_GROWTH = 1.25;
+
+    /* Per node bookkeeping of the layer maps, for the memory estimate. */
+    static const size_t NODE_OVERHEAD = 64;
+
+private:
+    typedef struct frontier_node_t
+    {
+        uint _g             = 0;
+        string _parent;
+        uint _parent_g      = 0;
+        /* Empty until the path reaches the relay threshold. */
+        string _relay;
+        uint _relay_g       = 0;
+        /* Action that produced the node, as in expanded_t. */
+        bool _embarking     = false;
+        bool _disembarking  = false;
+        uint _school        = 0;
+    } frontier_node_t;
+
+    typedef struct path_step_t
+    {
+        string _key;
+        uint _g;
+    } path_step_t;
+
+    typedef unordered_map<string, frontier_node_t> layer_t;
+
+    enum class outcome_t { FOUND, NOT_FOUND, STOPPED };
+
+    Graph const* _graph;
+    vector<station_t> _stations;
+    bus_t _bus;
+    heuristic_t _heuristic;
+    StateLayout _layout;
+    size_t _bytes_per_node;
+
+    /* Optimal cost once the first search is done. */
+    uint _optimal_cost          = 0;
+
+    /**
+        Search from 'start' for 'target', or for any final state
+        if 'target' is empty. Children with g over 'g_limit' or
+        g + h over 'f_limit' are pruned. When looking for final
+        states both limits shrink to the cheapest found and the
+        whole space under them is searched, otherwise the first
+        time 'target' is reached is enough.
+
+        'next_bound' receives a lower bound on the f of what was pruned.
+    */
+    outcome_t search( path_step_t const& start, string const& target,
+        uint g_limit, uint f_limit, pair<string, frontier_node_t>& found, uint& next_bound );
+
+    /**
+        Append to 'path' the steps after 'from' leading to the
+        node 'to', found by a search started at 'from'.
+    */
+    outcome_t recover( path_step_t const& from, pair<string, frontier_node_t> const& to,
+        vector< pair<string, frontier_node_t> >& path );
+
+    /* Search again from 'from' for 'to' and recover that path. */
+    outcome_t research( path_step_t const& from, path_step_t const& to,
+        vector< pair<string, frontier_node_t> >& path );
+
+    string pack( state_t const& state ) const;
+
+    size_t estimate_memory_use( size_t nodes ) const;
+};
+
+#endif
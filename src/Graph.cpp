@@ -1,5 +1,10 @@
 #include "Graph.h"
+#include "ContractionHierarchy.h"
 #include <stdexcept>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <climits>
 Graph::Graph(vector<Edge> const &edges, size_t N) 
 {
     // resize the vector to N elements of type vector<int>
@@ -68,6 +73,11 @@ size_t Graph::getVectorCount() const
 
 uint Graph::shortestPathCost(uint src, uint dest) const 
 {
+    if (!_distances.empty())
+        return _distances[(src-1) * _vector_count + (dest-1)];
+    if (_hierarchy)
+        return std::min<uint>(_hierarchy->distance(src, dest), INT8_MAX);
+
     int store_distance[_vector_count];
 
     for (size_t i=0; i<_vector_count; ++i)
@@ -90,6 +100,193 @@ uint Graph::shortestPathCost(uint src, uint dest) const
     return store_distance[dest-1];
 }
 
+vector<uint> Graph::shortestPathCosts(uint src) const
+{
+    vector<uint> cost(_vector_count, UINT32_MAX);
+    // (cost, node ID) pairs, cheapest first.
+    priority_queue< pair<uint, uint>, vector< pair<uint, uint> >, greater< pair<uint, uint> > > pending;
+
+    cost[src-1] = 0;
+    pending.push(make_pair(0, src));
+    while (!pending.empty())
+    {
+        pair<uint, uint> top = pending.top();
+        pending.pop();
+        if (top.first > cost[top.second-1])
+            continue;
+        for (const Transition& edge : transitions[top.second-1])
+        {
+            uint candidate = top.first + edge.cost;
+            if (candidate < cost[edge.destination-1]) {
+                cost[edge.destination-1] = candidate;
+                pending.push(make_pair(candidate, edge.destination));
+            }
+        }
+    }
+    return cost;
+}
+
+void Graph::precomputeShortestPaths()
+{
+    if (!_distances.empty() || _vector_count > MAX_PRECOMPUTED_NODES)
+        return;
+
+    // Bellman Ford starts every node at INT8_MAX, so its results 
+    // are the exact costs saturated at that value.
+    vector<uint> table(_vector_count * _vector_count);
+    for (uint src = 1; src <= _vector_count; ++src)
+    {
+        vector<uint> cost = shortestPathCosts(src);
+        for (size_t j = 0; j < _vector_count; ++j)
+            table[(src-1) * _vector_count + j] = std::min<uint>(cost[j], INT8_MAX);
+    }
+    _distances = std::move(table);
+}
+
+bool Graph::hasPrecomputedShortestPaths() const
+{
+    return !_distances.empty();
+}
+
+void Graph::precomputeLandmarks(size_t count)
+{
+    count = std::min(count, _vector_count);
+    _landmark_count = count;
+    _from_landmarks.assign(_vector_count * count, LANDMARK_UNREACHABLE);
+    _to_landmarks.assign(_vector_count * count, LANDMARK_UNREACHABLE);
+    if (count == 0)
+        return;
+
+    // Costs to a landmark are costs from it over the reversed edges.
+    vector<Edge> reversed_edges;
+    for (size_t src = 0; src < _vector_count; ++src)
+        for (const Transition& edge : transitions[src])
+            reversed_edges.push_back(Edge(edge.destination, src + 1, edge.cost));
+    Graph reversed(reversed_edges, _vector_count);
+
+    // Farthest point selection, starting from the node farthest from node 1.
+    vector<uint> closest = shortestPathCosts(1);
+    for (uint& cost : closest)
+        if (cost == UINT32_MAX)
+            cost = 0;
+    for (size_t l = 0; l < count; ++l)
+    {
+        uint landmark = 1;
+        for (size_t node = 0; node < _vector_count; ++node)
+            if (closest[node] > closest[landmark-1])
+                landmark = node + 1;
+
+        vector<uint> from = shortestPathCosts(landmark);
+        vector<uint> to = reversed.shortestPathCosts(landmark);
+        for (size_t node = 0; node < _vector_count; ++node)
+        {
+            if (from[node] != UINT32_MAX)
+                _from_landmarks[node * count + l] = static_cast<int32_t>(
+                    std::min<uint>(from[node], LANDMARK_UNREACHABLE - 1));
+            if (to[node] != UINT32_MAX)
+                _to_landmarks[node * count + l] = static_cast<int32_t>(
+                    std::min<uint>(to[node], LANDMARK_UNREACHABLE - 1));
+            // Unreachable nodes are never picked again.
+            uint cost = from[node] == UINT32_MAX ? 0 : from[node];
+            closest[node] = l == 0 ? cost : std::min(closest[node], cost);
+        }
+    }
+}
+
+size_t Graph::getLandmarkCount() const
+{
+    return _landmark_count;
+}
+
+uint Graph::landmarkLowerBound(uint src, uint dest) const
+{
+    const int32_t* from_src = &_from_landmarks[(src-1) * _landmark_count];
+    const int32_t* from_dest = &_from_landmarks[(dest-1) * _landmark_count];
+    const int32_t* to_src = &_to_landmarks[(src-1) * _landmark_count];
+    const int32_t* to_dest = &_to_landmarks[(dest-1) * _landmark_count];
+
+    // Branch free over contiguous runs, so the compiler vectorizes it.
+    int32_t bound = 0;
+    for (size_t l = 0; l < _landmark_count; ++l)
+    {
+        bound = std::max(bound, from_dest[l] - from_src[l]);
+        bound = std::max(bound, to_src[l] - to_dest[l]);
+    }
+    // Saturated as 'shortestPathCost' is.
+    return std::min<uint>(static_cast<uint>(bound), INT8_MAX);
+}
+
+uint Graph::distanceLowerBoundWithoutTable(uint src, uint dest) const
+{
+    if (_hierarchy)
+        return std::min<uint>(_hierarchy->distance(src, dest), INT8_MAX);
+    if (_landmark_count != 0)
+        return landmarkLowerBound(src, dest);
+    return shortestPathCost(src, dest);
+}
+
+void Graph::precomputeContractionHierarchy()
+{
+    if (!_hierarchy)
+        _hierarchy = make_shared<ContractionHierarchy const>(*this);
+}
+
+bool Graph::hasContractionHierarchy() const
+{
+    return _hierarchy != nullptr;
+}
+
+ContractionHierarchy const* Graph::getContractionHierarchy() const
+{
+    return _hierarchy.get();
+}
+
+uint Graph::shortestDistance(uint src, uint dest) const
+{
+    if (_hierarchy)
+        return _hierarchy->distance(src, dest);
+    return shortestPathCosts(src)[dest-1];
+}
+
+vector<uint> Graph::shortestPath(uint src, uint dest) const
+{
+    if (_hierarchy)
+        return _hierarchy->path(src, dest);
+
+    // Dijkstra from 'src', keeping the predecessor of every node.
+    vector<uint> cost(_vector_count, UINT32_MAX);
+    vector<uint> previous(_vector_count, 0);
+    priority_queue< pair<uint, uint>, vector< pair<uint, uint> >, greater< pair<uint, uint> > > pending;
+    cost[src-1] = 0;
+    pending.push(make_pair(0, src));
+    while (!pending.empty())
+    {
+        pair<uint, uint> top = pending.top();
+        pending.pop();
+        if (top.second == dest)
+            break;
+        if (top.first > cost[top.second-1])
+            continue;
+        for (const Transition& edge : getNeighbors(top.second))
+        {
+            uint candidate = top.first + edge.cost;
+            if (candidate < cost[edge.destination-1]) {
+                cost[edge.destination-1] = candidate;
+                previous[edge.destination-1] = top.second;
+                pending.push(make_pair(candidate, edge.destination));
+            }
+        }
+    }
+    if (cost[dest-1] == UINT32_MAX)
+        return vector<uint>();
+
+    vector<uint> path { dest };
+    for (uint node = dest; node != src; node = previous[node-1])
+        path.push_back(previous[node-1]);
+    reverse(path.begin(), path.end());
+    return path;
+}
+
 
 // uint Graph::shortestPathCost(uint src, uint dest) const 
 // {   
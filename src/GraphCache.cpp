@@ -0,0 +1,77 @@
+#include "GraphCache.h"
+#include "Hash.h"
+
+using namespace std;
+
+uint32_t GraphCache::map_hash( const Graph& graph )
+{
+    // Node count, then every row as (destination, cost) pairs 
+    // closed by a zero destination.
+    vector<uint> buffer;
+    buffer.push_back( static_cast<uint>(graph.getVectorCount()) );
+    for ( const vector<Transition>& row : graph.transitions ) {
+        for ( const Transition& t : row ) {
+            buffer.push_back( t.destination );
+            buffer.push_back( t.cost );
+        }
+        buffer.push_back( 0 );
+    }
+    return SFHash( reinterpret_cast<const char*>(buffer.data()),
+        static_cast<int>(buffer.size() * sizeof(uint)) );
+}
+
+shared_ptr<const Graph> GraphCache::acquire( Graph& graph )
+{
+    uint32_t key = map_hash( graph );
+    shared_ptr<entry_t> entry;
+    {
+        lock_guard<mutex> guard { _lock };
+        auto range = _entries.equal_range( key );
+        for ( auto it = range.first; it != range.second; ++it ) {
+            if ( it->second->graph->transitions == graph.transitions ) {
+                entry = it->second;
+                break;
+            }
+        }
+        if ( !entry ) {
+            entry = make_shared<entry_t>();
+            entry->graph = make_shared<Graph>( graph );
+            _entries.insert( make_pair(key, entry) );
+            evict();
+        }
+        entry->last_used = ++_clock;
+    }
+
+    // Precompute outside the lock so other maps are not held up.
+    call_once( entry->ready, [&entry]() {
+        entry->graph->precomputeShortestPaths();
+        if ( !entry->graph->hasPrecomputedShortestPaths() )
+            entry->graph->precomputeLandmarks( Graph::DEFAULT_LANDMARKS );
+    } );
+    return entry->graph;
+}
+
+size_t GraphCache::size() const
+{
+    lock_guard<mutex> guard { _lock };
+    return _entries.size();
+}
+
+void GraphCache::evict()
+{
+    if ( _max_maps == 0 )
+        return;
+    while ( _entries.size() > _max_maps ) {
+        // Only the cache holds an unused entry and its graph.
+        auto oldest = _entries.end();
+        for ( auto it = _entries.begin(); it != _entries.end(); ++it ) {
+            if ( it->second.use_count() != 1 || it->second->graph.use_count() != 1 )
+                continue;
+            if ( oldest == _entries.end() || it->second->last_used < oldest->second->last_used )
+                oldest = it;
+        }
+        if ( oldest == _entries.end() )
+            return;
+        _entries.erase( oldest );
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef GRAPHCACHE_H
+#define GRAPHCACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+    Keeps one copy of every distinct map together with its 
+    precomputed shortest path table, so problems sharing the 
+    same stations and costs do not redo that work.
+
+    Maps are keyed by 'map_hash' and compared edge by edge on 
+    a hash collision. Safe to use from several threads.
+
+    With a limit of 'max_maps', storing one more map drops the 
+    least recently acquired ones that nobody holds any longer. 
+    Maps still held stay, so the cache may go over the limit 
+    while they are in use.
+*/
+class GraphCache
+{
+public:
+    /* Keep at most 'max_maps' maps, zero means no limit. */
+    explicit GraphCache( size_t max_maps = 0 )
+    : _entries {}
+    , _max_maps { max_maps }
+    {}
+
+    /**
+        Return the shared copy of 'graph', storing it and 
+        precomputing its shortest paths on first use.
+    */
+    shared_ptr<const Graph> acquire( Graph& graph );
+
+    /**
+        Number of distinct maps stored.
+    */
+    size_t size() const;
+
+    /**
+        Hash of the stations and transition costs of a map.
+    */
+    static uint32_t map_hash( const Graph& graph );
+
+private:
+    typedef struct entry_t
+    {
+        shared_ptr<Graph> graph;
+        once_flag ready;
+        uint64_t last_used = 0;
+    } entry_t;
+
+    mutable mutex _lock;
+    multimap< uint32_t, shared_ptr<entry_t> > _entries;
+    size_t _max_maps;
+    uint64_t _clock = 0;
+
+    /* Drop unused maps, least recently acquired first, until 
+       the limit is met or every map left is in use. */
+    void evict();
+};
+
+#endif
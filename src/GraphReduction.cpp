@@ -0,0 +1,151 @@
+#include "GraphReduction.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+
+using namespace std;
+
+namespace {
+
+/**
+    Dijkstra from 'src' over 'graph', filling 'previous' with the
+    station every other one is reached from, 0 if it is not.
+*/
+vector<uint> shortest_paths( Graph const& graph, uint src, vector<uint>& previous )
+{
+    size_t size = graph.getVectorCount();
+    vector<uint> cost ( size, UINT32_MAX );
+    previous.assign( size, 0 );
+    priority_queue< pair<uint, uint>, vector< pair<uint, uint> >, greater< pair<uint, uint> > > pending;
+
+    cost[src - 1] = 0;
+    pending.push( make_pair(0, src) );
+    while ( !pending.empty() ) {
+        pair<uint, uint> top = pending.top();
+        pending.pop();
+        if ( top.first > cost[top.second - 1] )
+            continue;
+        for ( Transition const& edge : graph.getNeighbors(top.second) ) {
+            uint candidate = top.first + edge.cost;
+            if ( candidate < cost[edge.destination - 1] ) {
+                cost[edge.destination - 1] = candidate;
+                previous[edge.destination - 1] = top.second;
+                pending.push( make_pair(candidate, edge.destination) );
+            }
+        }
+    }
+    return cost;
+}
+
+vector<Edge> no_edges;
+
+} // namespace
+
+GraphReduction::GraphReduction( Graph const& graph, vector<station_t> const& stations,
+    bus_t const& bus, vector<school_t> const& schools )
+: _relevant {}
+, _index ( stations.size() + 1, 0 )
+, _original { no_edges, 0 }
+, _graph { no_edges, 0 }
+, _stations {}
+, _bus { bus }
+, _schools {}
+, _original_schools { schools }
+{
+    vector<bool> relevant ( stations.size() + 1, false );
+    relevant[bus._origin_station] = true;
+    relevant[bus._current_station] = true;
+    for ( school_t const& school : schools )
+        relevant[school._station_id] = true;
+    for ( station_t const& station : stations ) {
+        if ( !station._passengers.empty() )
+            relevant[station._id] = true;
+        for ( passenger_t const& passenger : station._passengers )
+            relevant[passenger._destination_id] = true;
+    }
+    for ( passenger_t const& passenger : bus._passengers )
+        relevant[passenger._destination_id] = true;
+
+    for ( uint id=1; id<relevant.size(); ++id ) {
+        if ( relevant[id] ) {
+            _relevant.push_back( id );
+            _index[id] = static_cast<uint>(_relevant.size());
+        }
+    }
+
+    // Complete graph with the shortest path costs.
+    vector<Edge> edges;
+    if ( graph.hasContractionHierarchy() ) {
+        _original = Graph( graph );
+        for ( size_t from=0; from<_relevant.size(); ++from ) {
+            for ( size_t to=0; to<_relevant.size(); ++to ) {
+                uint cost = to == from ? UINT32_MAX : graph.shortestDistance( _relevant[from], _relevant[to] );
+                if ( cost != UINT32_MAX )
+                    edges.push_back( Edge(from + 1, to + 1, cost) );
+            }
+        }
+    }
+    else {
+        _previous.resize( _relevant.size() );
+        for ( size_t from=0; from<_relevant.size(); ++from ) {
+            vector<uint> cost = shortest_paths( graph, _relevant[from], _previous[from] );
+            for ( size_t to=0; to<_relevant.size(); ++to )
+                if ( to != from && cost[_relevant[to] - 1] != UINT32_MAX )
+                    edges.push_back( Edge(from + 1, to + 1, cost[_relevant[to] - 1]) );
+        }
+    }
+    _graph = Graph( edges, _relevant.size() );
+    _graph.precomputeShortestPaths();
+    if ( !_graph.hasPrecomputedShortestPaths() )
+        _graph.precomputeLandmarks( graph.getLandmarkCount() ? graph.getLandmarkCount() : Graph::DEFAULT_LANDMARKS );
+
+    auto renumber = [this]( vector<passenger_t> const& passengers ) {
+        vector<passenger_t> result;
+        for ( passenger_t const& passenger : passengers )
+            result.push_back( passenger_t(_index[passenger._origin_id], _index[passenger._destination_id]) );
+        return result;
+    };
+    for ( uint id : _relevant ) {
+        vector<passenger_t> passengers = renumber( stations[id - 1]._passengers );
+        _stations.push_back( station_t(_index[id], passengers) );
+    }
+    _bus._origin_station = _index[bus._origin_station];
+    _bus._current_station = _index[bus._current_station];
+    _bus._passengers = renumber( bus._passengers );
+    for ( school_t const& school : schools )
+        _schools.push_back( school_t(school._id, _index[school._station_id]) );
+}
+
+vector<expanded_t> GraphReduction::expand( vector<expanded_t> const& ordered_recovery ) const
+{
+    vector<expanded_t> route;
+    uint last = 0;
+    for ( auto step = ordered_recovery.rbegin(); step != ordered_recovery.rend(); ++step ) {
+        expanded_t expanded = *step;
+        if ( !step->_embarking && !step->_disembarking && last != 0 && step->_station_id != last ) {
+            // Stations of the shortest path, but its ends.
+            vector<uint> between;
+            if ( _previous.empty() ) {
+                between = _original.shortestPath( original(last), original(step->_station_id) );
+                between.erase( between.begin() );
+                between.pop_back();
+            }
+            else {
+                vector<uint> const& previous = _previous[last - 1];
+                for ( uint at = previous[original(step->_station_id) - 1]; at != original(last); at = previous[at - 1] )
+                    between.push_back( at );
+                reverse( between.begin(), between.end() );
+            }
+            for ( uint at : between )
+                route.push_back( expanded_t(0, 0, at, false, false, 0) );
+        }
+        if ( !step->_embarking && !step->_disembarking )
+            last = step->_station_id;
+        expanded._station_id = original( step->_station_id );
+        expanded._school_destination = original( step->_school_destination );
+        route.push_back( expanded );
+    }
+    reverse( route.begin(), route.end() );
+    return route;
+}
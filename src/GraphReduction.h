@@ -0,0 +1,74 @@
+#ifndef GRAPHREDUCTION_H
+#define GRAPHREDUCTION_H
+
+#include <vector>
+#include "Graph.h"
+#include "ClosedSet.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    The problem over its relevant stations only: the bus origin
+    and current station, the stations with passengers waiting and
+    the schools. They are renumbered from 1 in the order of their
+    original IDs and joined by an edge wherever the original map
+    has a path, with the cost of the shortest one.
+
+    Stations in between only appear as intermediate states of a
+    search, so searching the reduced problem finds solutions as
+    cheap with fewer, shallower states. 'expand' turns its routes
+    back into routes over the original map. Among routes of the
+    same cost it may find another one than a search over the
+    original map, with another number of stops.
+
+    If the original map has a contraction hierarchy, the costs and
+    paths come from it instead of a Dijkstra search per relevant
+    station, so reducing a map of 100k stations takes milliseconds.
+*/
+class GraphReduction
+{
+public:
+    GraphReduction( Graph const& graph, vector<station_t> const& stations,
+        bus_t const& bus, vector<school_t> const& schools );
+
+    Graph const& graph() const { return _graph; }
+    vector<station_t>& stations() { return _stations; }
+    bus_t& bus() { return _bus; }
+    vector<school_t> const& schools() const { return _schools; }
+    vector<school_t> const& original_schools() const { return _original_schools; }
+
+    /* Stations of the original and of the reduced map. */
+    size_t original_size() const { return _index.size() - 1; }
+    size_t reduced_size() const { return _relevant.size(); }
+
+    /**
+        Turn a route of the reduced problem, from the final node
+        back to the initial one as SearchEngine::format_route
+        takes it, into the same route over the original map: 
+        every transit gets the stations of its shortest path, 
+        and stations are renumbered back.
+    */
+    vector<expanded_t> expand( vector<expanded_t> const& ordered_recovery ) const;
+
+private:
+    /* Original ID of every reduced station, and the reverse, 0
+       for the stations left out. */
+    vector<uint> _relevant;
+    vector<uint> _index;
+    /* Per relevant station, the previous station of the shortest
+       path to every original station, indexed by ID - 1. Empty if
+       the paths come from the hierarchy of '_original'. */
+    vector< vector<uint> > _previous;
+    Graph _original;
+
+    Graph _graph;
+    vector<station_t> _stations;
+    bus_t _bus;
+    vector<school_t> _schools;
+    vector<school_t> _original_schools;
+
+    uint original( uint reduced ) const { return reduced == 0 ? 0 : _relevant[reduced - 1]; }
+};
+
+#endif
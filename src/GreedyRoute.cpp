@@ -0,0 +1,81 @@
+#include "GreedyRoute.h"
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+uint greedy_route_cost( Graph const* graph, vector<station_t> const& stations, bus_t const& bus )
+{
+    // Shortest path costs from a station, computed once it is visited.
+    vector< vector<uint> > distances ( stations.size() + 1 );
+    auto distance = [&]( uint from, uint to ) {
+        if ( distances[from].empty() )
+            distances[from] = graph->shortestPathCosts( from );
+        return distances[from][to - 1];
+    };
+
+    vector< vector<uint> > waiting ( stations.size() + 1 );
+    size_t waiting_total = 0;
+    for ( station_t const& station : stations )
+        for ( passenger_t const& passenger : station._passengers ) {
+            waiting[station._id].push_back( passenger._destination_id );
+            ++waiting_total;
+        }
+    vector<uint> on_board;
+    for ( passenger_t const& passenger : bus._passengers )
+        on_board.push_back( passenger._destination_id );
+
+    uint station = bus._current_station;
+    uint64_t cost = 0;
+    while ( true ) {
+        size_t before = on_board.size();
+        on_board.erase( remove( on_board.begin(), on_board.end(), station ), on_board.end() );
+        cost += before - on_board.size();
+
+        vector<uint>& here = waiting[station];
+        if ( !here.empty() && on_board.size() < bus._max_passengers ) {
+            sort( here.begin(), here.end(), [&]( uint a, uint b ) {
+                return distance( station, a ) > distance( station, b );
+            } );
+            while ( !here.empty() && on_board.size() < bus._max_passengers ) {
+                on_board.push_back( here.back() );
+                here.pop_back();
+                --waiting_total;
+                ++cost;
+            }
+            // Anyone going to this very station gets off again.
+            continue;
+        }
+
+        uint target = 0;
+        uint nearest = UINT_MAX;
+        auto consider = [&]( uint candidate ) {
+            uint d = distance( station, candidate );
+            if ( d < nearest ) {
+                nearest = d;
+                target = candidate;
+            }
+        };
+        for ( uint destination : on_board )
+            consider( destination );
+        if ( on_board.size() < bus._max_passengers )
+            for ( size_t id=1; id<waiting.size(); ++id )
+                if ( !waiting[id].empty() && id != station )
+                    consider( id );
+
+        if ( target == 0 ) {
+            // Passengers left waiting with no room for them.
+            if ( waiting_total != 0 || !on_board.empty() )
+                return UINT_MAX;
+            if ( station == bus._origin_station )
+                break;
+            target = bus._origin_station;
+            nearest = distance( station, target );
+        }
+        if ( nearest == UINT32_MAX )
+            return UINT_MAX;
+        cost += nearest;
+        station = target;
+    }
+    return cost < UINT_MAX ? static_cast<uint>(cost) : UINT_MAX;
+}
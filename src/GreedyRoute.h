@@ -0,0 +1,24 @@
+#ifndef GREEDYROUTE_H
+#define GREEDYROUTE_H
+
+#include <vector>
+#include "Graph.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    Cost of a route built greedily: drop off whoever goes to the
+    current station, pick up whoever waits there while there is
+    room, nearest destination first, then take the shortest path
+    to the nearest station to drop off or, with room left, to pick
+    up at, and back to the origin once everyone is delivered.
+
+    Stops and passengers cost 1 each, as in state_t, so it is the
+    cost of a real solution and an upper bound on the optimal one.
+    Returns UINT_MAX if the greedy gets stuck, e.g. on a station
+    it cannot reach.
+*/
+uint greedy_route_cost( Graph const* graph, vector<station_t> const& stations, bus_t const& bus );
+
+#endif
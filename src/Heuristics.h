@@ -0,0 +1,43 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <algorithm>
+#include "State.h"
+
+using namespace std;
+
+/**
+    Heuristic policies. Each evaluates states with one heuristic,
+    so a search templated on a policy has the heuristic resolved
+    at compile time instead of on every evaluation.
+*/
+struct no_heuristic_t
+{
+    static uint evaluate( state_t const& ) { return 0; }
+};
+
+struct max_distance_passenger_t
+{
+    static uint evaluate( state_t const& state )
+    {
+        return state.max_distance_to_deliver_passenger();
+    }
+};
+
+struct max_distance_station_t
+{
+    static uint evaluate( state_t const& state )
+    {
+        return state.max_cost_to_passenger();
+    }
+};
+
+struct all_heuristics_t
+{
+    static uint evaluate( state_t const& state )
+    {
+        return std::max( state.max_distance_to_deliver_passenger(), state.max_cost_to_passenger() );
+    }
+};
+
+#endif
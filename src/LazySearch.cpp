@@ -0,0 +1,215 @@
+#include "LazySearch.h"
+#include "assert.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+
+using namespace std;
+
+LazySearch::LazySearch( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename )
+: SearchEngine { schools, filename }
+, _initial { graph, stations, bus, heuristic }
+, _closed_states { }
+, _paths { stations.size(), schools }
+{
+    size_t passengers = bus._passengers.size();
+    for (station_t const& station : stations)
+        passengers += station._passengers.size();
+    _bytes_per_parent = sizeof(parent_t) + sizeof(state_t) + stations.size() * sizeof(station_t)
+        + passengers * sizeof(passenger_t);
+    _stats._bytes_per_open_node = sizeof(lazy_entry_t) + OPEN_NODE_OVERHEAD;
+    _stats._bytes_per_closed_node = sizeof(uint32_t) + CLOSED_NODE_OVERHEAD + sizeof(path_record_t);
+}
+
+LazySearch::~LazySearch()
+{
+    for ( parent_t const& parent : _parents )
+        delete parent._state;
+}
+
+bool LazySearch::solve()
+{
+    auto start = std::chrono::steady_clock::now();
+    _solved = false;
+    _status = search_status_t::EXHAUSTED;
+
+    ++_stats._heuristic_evaluations;
+    _open_states.insert( make_pair( _initial.get_heuristic_cost(), lazy_entry_t { NO_SLOT, 0 } ) );
+
+    if (_verbose)
+        cout << "Search started";
+    while ( !_open_states.empty() ) {
+        if (_stats._number_of_expansions % 100000 == 0 && _verbose)
+            cout << "." << flush;
+        size_t memory = estimate_memory_use();
+        _stats._peak_memory_estimate = std::max( _stats._peak_memory_estimate, memory );
+        if (_memory_limit != 0 && memory > _memory_limit) {
+            _status = search_status_t::MEMORY_LIMIT;
+            break;
+        }
+        if (deadline_passed()) {
+            _status = search_status_t::DEADLINE;
+            break;
+        }
+        if (_stop_requested) {
+            _status = search_status_t::INTERRUPTED;
+            break;
+        }
+
+        uint f = _open_states.begin()->first;
+        lazy_entry_t entry = _open_states.begin()->second;
+        _open_states.erase( _open_states.begin() );
+
+        if ( entry._operator == REQUEUED ) {
+            --_parents[entry._parent]._pending;
+            expand( entry._parent, f );
+            continue;
+        }
+
+        // Build the state now that it is needed.
+        uint32_t parent_record = PathStore::NO_PARENT;
+        state_t candidate = _initial;
+        if ( entry._parent != NO_SLOT ) {
+            parent_t const& parent = _parents[entry._parent];
+            candidate = parent._state->get_successor( entry._operator );
+            // Queued with the f 'successor_costs' predicted for it.
+            assert( candidate.get_total_cost() == f && "successor f mispredicted" );
+            ++_stats._generated;
+            parent_record = parent._record;
+            release( entry._parent );
+        }
+
+        if ( candidate.is_final() ) {
+            if (_verbose)
+                cout << "success!" << endl << flush;
+            _solved = true;
+            _status = search_status_t::SOLVED;
+            _stats._solution_cost = candidate.get_transition_cost();
+
+            vector<expanded_t> ordered_recovery;
+            ordered_recovery.push_back( candidate.get_expansion() );
+            vector<expanded_t> path = _paths.path_to( parent_record );
+            ordered_recovery.insert( ordered_recovery.end(), path.begin(), path.end() );
+            _solution = format_route( ordered_recovery );
+            break;
+        }
+
+        if ( _closed_states.lookup( candidate.get_id() ) ) {
+            ++_stats._duplicates_pruned;
+            continue;
+        }
+        ++_stats._number_of_expansions;
+        _closed_states.insert( candidate.get_id() );
+        uint32_t record = _paths.append( parent_record, candidate.get_expansion() );
+        expand( allocate( candidate, record ), f );
+
+        _stats._peak_open = std::max<uint64_t>( _stats._peak_open, _open_states.size() );
+        _stats._peak_closed = _closed_states.size();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    _stats._elapsed_seconds = elapsed.count();
+    _stats._timeline.push_back( make_pair( _stats._elapsed_seconds, _stats._number_of_expansions ) );
+
+    if ( !_solved && _verbose ) {
+        if (_status == search_status_t::MEMORY_LIMIT)
+            cout << endl << "Memory limit reached." << endl;
+        else if (_status == search_status_t::DEADLINE)
+            cout << endl << "Deadline reached." << endl;
+        else if (_status == search_status_t::INTERRUPTED)
+            cout << endl << "Interrupted." << endl;
+        else
+            cout << endl << "No solution could be found." << endl;
+    }
+    return _solved;
+}
+
+void LazySearch::expand( uint32_t slot, uint f )
+{
+    state_t const* state = _parents[slot]._state;
+    uint bound = _parents[slot]._bound;
+    uint next = UINT_MAX;
+
+    vector<uint> costs = successor_costs( *state );
+    for ( uint op=0; op<costs.size(); ++op ) {
+        uint successor_f = costs[op];
+        if ( successor_f < bound )
+            continue;
+        if ( successor_f <= f ) {
+            _open_states.insert( make_pair( successor_f, lazy_entry_t { slot, op } ) );
+            ++_parents[slot]._pending;
+            ++_stats._stored;
+        }
+        else
+            next = std::min( next, successor_f );
+    }
+    _parents[slot]._bound = f + 1;
+
+    if ( next != UINT_MAX ) {
+        _open_states.insert( make_pair( next, lazy_entry_t { slot, REQUEUED } ) );
+        ++_parents[slot]._pending;
+        ++_stats._requeued;
+    }
+    else if ( _parents[slot]._pending == 0 )
+        free_slot( slot );
+}
+
+vector<uint> LazySearch::successor_costs( state_t const& state )
+{
+    vector<uint> costs;
+    uint operators = state.get_operator_count();
+    for ( uint op=0; op<operators; ++op ) {
+        state_t successor = state.get_successor( op );
+        ++_stats._generated;
+        ++_stats._heuristic_evaluations;
+        costs.push_back( successor.get_total_cost() );
+    }
+    return costs;
+}
+
+vector<uint> EPEASearch::successor_costs( state_t const& state )
+{
+    vector<uint> costs = state.get_successor_total_costs();
+    _stats._heuristic_evaluations += costs.size();
+    return costs;
+}
+
+void LazySearch::release( uint32_t slot )
+{
+    if ( --_parents[slot]._pending == 0 )
+        free_slot( slot );
+}
+
+void LazySearch::free_slot( uint32_t slot )
+{
+    parent_t& parent = _parents[slot];
+    delete parent._state;
+    parent._state = nullptr;
+    _free_slots.push_back( slot );
+    --_live_parents;
+}
+
+uint32_t LazySearch::allocate( state_t const& state, uint32_t record )
+{
+    parent_t parent { new state_t( state ), record, 0, 0 };
+    ++_live_parents;
+    if ( !_free_slots.empty() ) {
+        uint32_t slot = _free_slots.back();
+        _free_slots.pop_back();
+        _parents[slot] = parent;
+        return slot;
+    }
+    _parents.push_back( parent );
+    return static_cast<uint32_t>( _parents.size() - 1 );
+}
+
+size_t LazySearch::estimate_memory_use() const
+{
+    return _open_states.size() * _stats._bytes_per_open_node
+        + _closed_states.size() * (sizeof(uint32_t) + CLOSED_NODE_OVERHEAD)
+        + _paths.size() * sizeof(path_record_t)
+        + _live_parents * _bytes_per_parent;
+}
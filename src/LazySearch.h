@@ -0,0 +1,132 @@
+#ifndef LAZYSEARCH_H
+#define LAZYSEARCH_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "ClosedSet.h"
+#include "PathStore.h"
+#include "SearchEngine.h"
+#include "State.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    A* with partial expansion and lazy successors. The open list
+    does not hold states but (parent, operator) pairs, and a state
+    is only built from its parent when it is taken from the list.
+    Only expanded nodes with successors still queued keep their
+    state.
+
+    Expanding a node with f = F evaluates all of its successors
+    but only queues the ones with f <= F. If others are left, the
+    node goes back to the open list with the lowest f among them,
+    and the next time it is taken queues the ones up to that f.
+    Successors over the cost of the solution are never stored.
+
+    Nodes are identified and closed as in Solver, and paths are
+    kept in a PathStore.
+*/
+class LazySearch : public SearchEngine
+{
+public:
+    /**
+        Same arguments as Solver.
+    */
+    LazySearch( Graph const * graph, vector<school_t> schools,
+        vector<station_t>& stations, bus_t& bus,
+        heuristic_t heuristic, string filename );
+
+    ~LazySearch();
+
+    bool solve() override;
+
+    /* Allocator and container bookkeeping per stored node. The
+       closed set, a hash table at most half full, keeps one to
+       three spare slots per ID. */
+    static const size_t OPEN_NODE_OVERHEAD = 64;
+    static const size_t CLOSED_NODE_OVERHEAD = 2 * sizeof(uint32_t);
+
+protected:
+    /**
+        g + h of the successors of 'state', in the order of its
+        operators. Builds every successor.
+    */
+    virtual vector<uint> successor_costs( state_t const& state );
+
+private:
+    /**
+        An expanded node whose state is kept to build the
+        successors it has in the open list.
+    */
+    typedef struct parent_t
+    {
+        state_t const* _state;
+        /* Its record in the path store. */
+        uint32_t _record;
+        /* Successors with f under this one are already queued. */
+        uint _bound;
+        /* Open list entries that need '_state'. */
+        uint32_t _pending;
+    } parent_t;
+
+    /**
+        Open list entry: successor '_operator' of the parent in
+        slot '_parent', or the parent itself when it is REQUEUED.
+    */
+    typedef struct lazy_entry_t
+    {
+        uint32_t _parent;
+        uint32_t _operator;
+    } lazy_entry_t;
+
+    static const uint32_t NO_SLOT = UINT32_MAX;
+    static const uint32_t REQUEUED = UINT32_MAX;
+
+    state_t _initial;
+    ClosedSet _closed_states;
+    PathStore _paths;
+    multimap<uint, lazy_entry_t> _open_states;
+
+    /* Parents by slot, and the slots free for reuse. */
+    vector<parent_t> _parents;
+    vector<uint32_t> _free_slots;
+    size_t _live_parents            = 0;
+    size_t _bytes_per_parent;
+
+    /**
+        Queue the successors of the parent in 'slot' with f over
+        its bound and up to 'f', and requeue the parent with the
+        f of the next ones if any are left.
+    */
+    void expand( uint32_t slot, uint f );
+
+    /* Drop an open list entry's claim on the parent in 'slot'. */
+    void release( uint32_t slot );
+
+    /* Delete the state of a parent nothing needs any more. */
+    void free_slot( uint32_t slot );
+
+    uint32_t allocate( state_t const& state, uint32_t record );
+
+    size_t estimate_memory_use() const;
+};
+
+/**
+    Enhanced partial expansion A*: LazySearch that takes the f of
+    every successor from state_t::get_successor_total_costs, which
+    knows how each operator changes the terms of the heuristic,
+    so only the successors that get queued are ever built.
+*/
+class EPEASearch : public LazySearch
+{
+public:
+    using LazySearch::LazySearch;
+
+protected:
+    vector<uint> successor_costs( state_t const& state ) override;
+};
+
+#endif
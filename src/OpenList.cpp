@@ -0,0 +1,103 @@
+#include "OpenList.h"
+#include <algorithm>
+
+using namespace std;
+
+OpenList::~OpenList()
+{
+    for ( open_entry_t const& entry : _heap )
+        delete _nodes[entry._node]._state;
+}
+
+bool OpenList::before( open_entry_t const& a, open_entry_t const& b )
+{
+    return a._f < b._f || (a._f == b._f && a._sequence < b._sequence);
+}
+
+void OpenList::push( uint32_t f, uint32_t g, state_t const* state, uint32_t parent_record )
+{
+    uint32_t node;
+    if ( _free_nodes.empty() ) {
+        node = static_cast<uint32_t>(_nodes.size());
+        _nodes.push_back( open_node_t { state, parent_record } );
+    }
+    else {
+        node = _free_nodes.back();
+        _free_nodes.pop_back();
+        _nodes[node] = open_node_t { state, parent_record };
+    }
+
+    if ( _next_sequence == UINT32_MAX )
+        renumber();
+    _heap.push_back( open_entry_t { f, g, node, _next_sequence++ } );
+    sift_up( _heap.size() - 1 );
+}
+
+void OpenList::pop()
+{
+    uint32_t node = _heap.front()._node;
+    delete _nodes[node]._state;
+    _nodes[node]._state = nullptr;
+    _free_nodes.push_back( node );
+
+    _heap.front() = _heap.back();
+    _heap.pop_back();
+    if ( !_heap.empty() )
+        sift_down( 0 );
+}
+
+void OpenList::sift_up( size_t index )
+{
+    open_entry_t entry = _heap[index];
+    while ( index > 0 ) {
+        size_t parent = (index - 1) / 2;
+        if ( !before( entry, _heap[parent] ) )
+            break;
+        _heap[index] = _heap[parent];
+        index = parent;
+    }
+    _heap[index] = entry;
+}
+
+void OpenList::sift_down( size_t index )
+{
+    open_entry_t entry = _heap[index];
+    size_t size = _heap.size();
+    while ( true ) {
+        size_t child = 2 * index + 1;
+        if ( child >= size )
+            break;
+        if ( child + 1 < size && before( _heap[child + 1], _heap[child] ) )
+            ++child;
+        if ( !before( _heap[child], entry ) )
+            break;
+        _heap[index] = _heap[child];
+        index = child;
+    }
+    _heap[index] = entry;
+}
+
+void OpenList::visit( function<void(open_entry_t const&, open_node_t const&)> visit ) const
+{
+    vector<open_entry_t> ordered = _heap;
+    sort( ordered.begin(), ordered.end(), before );
+    for ( open_entry_t const& entry : ordered )
+        visit( entry, _nodes[entry._node] );
+}
+
+void OpenList::swap( OpenList& other )
+{
+    _heap.swap( other._heap );
+    _nodes.swap( other._nodes );
+    _free_nodes.swap( other._free_nodes );
+    std::swap( _next_sequence, other._next_sequence );
+}
+
+void OpenList::renumber()
+{
+    // A sorted array is a heap as well.
+    sort( _heap.begin(), _heap.end(), before );
+    for ( size_t i=0; i<_heap.size(); ++i )
+        _heap[i]._sequence = static_cast<uint32_t>(i);
+    _next_sequence = static_cast<uint32_t>(_heap.size());
+}
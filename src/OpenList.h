@@ -0,0 +1,93 @@
+#ifndef OPENLIST_H
+#define OPENLIST_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "State.h"
+
+using namespace std;
+
+/**
+    Entry of the open list: a state and the path record of the
+    state it was generated from.
+*/
+typedef struct open_node_t
+{
+    state_t const* _state;
+    uint32_t _parent_record;
+} open_node_t;
+
+/**
+    What the priority queue orders: the f and g of a node, where
+    its open_node_t is stored and its place among the nodes with
+    the same f.
+*/
+typedef struct open_entry_t
+{
+    uint32_t _f;
+    uint32_t _g;
+    uint32_t _node;
+    uint32_t _sequence;
+} open_entry_t;
+
+/**
+    Open list of A* split into hot and cold data.
+
+    The priority queue is a binary heap of 16 byte open_entry_t,
+    four to a cache line, so sifting an entry up or down never
+    reads a state. States live in a separate store of open_node_t,
+    addressed by the entry, and are only read once popped.
+
+    Nodes with the same f are popped in the order they were
+    pushed, as they were out of the multimap this replaces, so
+    searches expand the same nodes in the same order.
+
+    The list owns the states pushed into it: 'pop' and the
+    destructor delete them.
+*/
+class OpenList
+{
+public:
+    OpenList() = default;
+    ~OpenList();
+
+    OpenList( OpenList const& ) = delete;
+    OpenList& operator=( OpenList const& ) = delete;
+
+    void push( uint32_t f, uint32_t g, state_t const* state, uint32_t parent_record );
+
+    bool empty() const { return _heap.empty(); }
+    size_t size() const { return _heap.size(); }
+
+    /* Entry with the lowest f, pushed first among those. */
+    open_entry_t const& top() const { return _heap.front(); }
+
+    open_node_t const& node( uint32_t index ) const { return _nodes[index]; }
+
+    /* Remove the top entry and delete its state. */
+    void pop();
+
+    /* Call 'visit' on every entry and its node, in pop order. */
+    void visit( function<void(open_entry_t const&, open_node_t const&)> visit ) const;
+
+    void swap( OpenList& other );
+
+private:
+    vector<open_entry_t> _heap;
+    vector<open_node_t> _nodes;
+    /* Indices of the nodes popped, reused by the next pushes. */
+    vector<uint32_t> _free_nodes;
+    uint32_t _next_sequence = 0;
+
+    static bool before( open_entry_t const& a, open_entry_t const& b );
+
+    void sift_up( size_t index );
+    void sift_down( size_t index );
+
+    /* Number the entries from 0 again in pop order, once the
+       sequence numbers run out. */
+    void renumber();
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "Options.h"
+
+using namespace std;
+
+string get_option( int argc, char* argv[], const string& name, const string& fallback )
+{
+    string prefix = "--" + name;
+    for ( int i=1; i<argc; ++i ) {
+        string arg = argv[i];
+        if ( arg == prefix )
+            return "";
+        if ( arg.compare(0, prefix.size() + 1, prefix + "=") == 0 )
+            return arg.substr(prefix.size() + 1);
+    }
+    return fallback;
+}
+
+bool has_option( int argc, char* argv[], const string& name )
+{
+    return get_option(argc, argv, name, "\n") != "\n";
+}
+
+vector<string> get_positional( int argc, char* argv[] )
+{
+    vector<string> positional;
+    for ( int i=1; i<argc; ++i ) {
+        if ( string(argv[i]).compare(0, 2, "--") != 0 )
+            positional.push_back(argv[i]);
+    }
+    return positional;
+}
+
+vector<string> split_list( const string& value )
+{
+    vector<string> items;
+    size_t start = 0;
+    while ( start <= value.size() ) {
+        size_t end = value.find(',', start);
+        if ( end == string::npos )
+            end = value.size();
+        if ( end > start )
+            items.push_back( value.substr(start, end - start) );
+        start = end + 1;
+    }
+    return items;
+}
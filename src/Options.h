@@ -0,0 +1,28 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+    Return the value of a '--name=value' command line option, 
+    or 'fallback' if it was not given. A bare '--name' has an 
+    empty value.
+*/
+string get_option( int argc, char* argv[], const string& name, const string& fallback );
+
+bool has_option( int argc, char* argv[], const string& name );
+
+/**
+    Arguments that are not options, in order.
+*/
+vector<string> get_positional( int argc, char* argv[] );
+
+/**
+    Split a comma separated option value: "a,b,c" -> [a, b, c].
+*/
+vector<string> split_list( const string& value );
+
+#endif
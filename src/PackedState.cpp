@@ -0,0 +1,128 @@
+#include "PackedState.h"
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+uint16_t read_u16( const uint8_t* at )
+{
+    uint16_t value;
+    memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+void write_u16( uint8_t* at, size_t value )
+{
+    uint16_t narrow = static_cast<uint16_t>(value);
+    memcpy(at, &narrow, sizeof(narrow));
+}
+
+} // namespace
+
+StateLayout::StateLayout( vector<station_t> const& stations, bus_t const& bus )
+: _classes {}
+, _station_count { stations.size() }
+, _bus { bus }
+{
+    _bus._passengers.clear();
+
+    vector<size_t> counts;
+    auto add = [this, &counts]( passenger_t const& passenger ) {
+        for ( size_t c=0; c<_classes.size(); ++c ) {
+            if ( _classes[c]._origin == passenger._origin_id
+                && _classes[c]._destination == passenger._destination_id ) {
+                ++counts[c];
+                return;
+            }
+        }
+        _classes.push_back( passenger_class_t { passenger._origin_id, passenger._destination_id } );
+        counts.push_back( 1 );
+    };
+    for ( station_t const& station : stations )
+        for ( passenger_t const& passenger : station._passengers )
+            add( passenger );
+    for ( passenger_t const& passenger : bus._passengers )
+        add( passenger );
+
+    if ( _station_count > UINT16_MAX )
+        throw runtime_error( "too many stations to pack a state" );
+    for ( size_t count : counts ) {
+        if ( count > UINT16_MAX )
+            throw runtime_error( "too many passengers in a class to pack a state" );
+    }
+}
+
+size_t StateLayout::key_size() const
+{
+    return sizeof(uint16_t) * (1 + 2 * _classes.size());
+}
+
+size_t StateLayout::class_count() const { return _classes.size(); }
+
+size_t StateLayout::class_of( passenger_t const& passenger ) const
+{
+    for ( size_t c=0; c<_classes.size(); ++c ) {
+        if ( _classes[c]._origin == passenger._origin_id
+            && _classes[c]._destination == passenger._destination_id )
+            return c;
+    }
+    throw runtime_error( "passenger does not belong to the problem" );
+}
+
+void StateLayout::pack( state_t const& state, uint8_t* key ) const
+{
+    vector<size_t> waiting ( _classes.size(), 0 );
+    vector<size_t> on_board ( _classes.size(), 0 );
+
+    bus_t bus = state.get_bus();
+    for ( passenger_t const& passenger : bus._passengers )
+        ++on_board[ class_of(passenger) ];
+    for ( station_t const& station : state.get_vector_stations() )
+        for ( passenger_t const& passenger : station._passengers )
+            ++waiting[ class_of(passenger) ];
+
+    write_u16( key, bus._current_station );
+    for ( size_t c=0; c<_classes.size(); ++c ) {
+        write_u16( key + sizeof(uint16_t) * (1 + 2 * c), waiting[c] );
+        write_u16( key + sizeof(uint16_t) * (2 + 2 * c), on_board[c] );
+    }
+}
+
+state_t StateLayout::unpack( const uint8_t* key, Graph const* graph, heuristic_t heuristic,
+    uint cost, expanded_t const& expansion ) const
+{
+    vector<station_t> stations;
+    for ( size_t i=0; i<_station_count; ++i )
+        stations.push_back( station_t(i + 1) );
+
+    bus_t bus = _bus;
+    bus._current_station = station_of( key );
+    for ( size_t c=0; c<_classes.size(); ++c ) {
+        passenger_t passenger ( _classes[c]._origin, _classes[c]._destination );
+        uint16_t waiting = read_u16( key + sizeof(uint16_t) * (1 + 2 * c) );
+        uint16_t on_board = read_u16( key + sizeof(uint16_t) * (2 + 2 * c) );
+        for ( uint16_t p=0; p<waiting; ++p )
+            stations[passenger._origin_id - 1]._passengers.push_back( passenger );
+        for ( uint16_t p=0; p<on_board; ++p )
+            bus._passengers.push_back( passenger );
+    }
+    return state_t( graph, stations, bus, heuristic, cost, expansion );
+}
+
+bool StateLayout::is_final( const uint8_t* key ) const
+{
+    if ( station_of(key) != _bus._origin_station )
+        return false;
+    for ( size_t i=1; i<=2 * _classes.size(); ++i ) {
+        if ( read_u16( key + sizeof(uint16_t) * i ) != 0 )
+            return false;
+    }
+    return true;
+}
+
+uint StateLayout::station_of( const uint8_t* key )
+{
+    return read_u16( key );
+}
@@ -0,0 +1,70 @@
+#ifndef PACKEDSTATE_H
+#define PACKEDSTATE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "State.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    Passengers sharing origin and destination can not be told
+    apart, so a configuration of the problem is fully described
+    by the bus station plus, for every such passenger class, how
+    many of them are still waiting and how many ride the bus.
+
+    StateLayout packs that description into a fixed size key,
+    independent of the path that reached it, and rebuilds states
+    from it. Keys compare with memcmp.
+
+        [station u16] [waiting u16, on board u16] per class
+*/
+class StateLayout
+{
+public:
+    /**
+        Classes are taken from the passengers of the initial
+        'stations' and 'bus'. Throws runtime_error if a count
+        does not fit in the key.
+    */
+    StateLayout( vector<station_t> const& stations, bus_t const& bus );
+
+    size_t key_size() const;
+
+    size_t class_count() const;
+
+    void pack( state_t const& state, uint8_t* key ) const;
+
+    /**
+        Rebuild the configuration stored in 'key' as a state
+        with the given cost and expanded form.
+    */
+    state_t unpack( const uint8_t* key, Graph const* graph, heuristic_t heuristic,
+        uint cost, expanded_t const& expansion ) const;
+
+    /**
+        True if nobody is waiting or on board and the bus is
+        back at its origin.
+    */
+    bool is_final( const uint8_t* key ) const;
+
+    static uint station_of( const uint8_t* key );
+
+private:
+    typedef struct passenger_class_t
+    {
+        uint _origin;
+        uint _destination;
+    } passenger_class_t;
+
+    vector<passenger_class_t> _classes;
+    size_t _station_count;
+    bus_t _bus;
+
+    size_t class_of( passenger_t const& passenger ) const;
+};
+
+#endif
@@ -0,0 +1,287 @@
+#include "ParallelDepthFirstSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+ParallelDepthFirstSearch::ParallelDepthFirstSearch( Graph const * graph, vector<school_t> schools,
+    vector<station_t>& stations, bus_t& bus,
+    heuristic_t heuristic, string filename, uint threads )
+: SearchEngine { schools, filename }
+, _initial { graph, stations, bus, heuristic }
+, _initial_station { bus._current_station }
+{
+    for ( uint i=0; i < std::max<uint>( threads, 1 ); ++i )
+        _workers.emplace_back( new worker_t( _initial ) );
+    _stats._bytes_per_open_node = sizeof(search_op_t);
+    _stats._bytes_per_closed_node = sizeof(closed_slot_t) * 100 / ConcurrentClosedTable::MAX_LOAD_PERCENT;
+}
+
+bool ParallelDepthFirstSearch::solve()
+{
+    auto start = std::chrono::steady_clock::now();
+    _solved = false;
+    _status = search_status_t::EXHAUSTED;
+
+    uint bound = _initial.heuristic();
+    size_t closed_bytes = 0;
+    if (_verbose)
+        cout << "Search started on " << _workers.size() << " threads" << endl;
+    while ( true ) {
+        _next_bound = UINT_MAX;
+        _idle = 0;
+        _pending = 1;
+        _workers[0]->_tasks.push_back( task_t { {}, 0 } );
+        _workers[0]->_queued = 1;
+        // Start as large as the last iteration's table got.
+        if ( _use_closed )
+            _closed.reset( new ConcurrentClosedTable( _closed ? _closed->capacity()
+                : ConcurrentClosedTable::INITIAL_CAPACITY ) );
+
+        uint64_t expansions = _stats._number_of_expansions;
+        vector<thread> pool;
+        for ( size_t i=0; i<_workers.size(); ++i )
+            pool.push_back( thread( &ParallelDepthFirstSearch::work, this, i, bound ) );
+        for ( thread& t : pool )
+            t.join();
+
+        _stats._number_of_expansions = 0;
+        for ( auto const& worker : _workers )
+            _stats._number_of_expansions += worker->_expansions;
+        if ( _closed ) {
+            _stats._peak_closed = std::max<uint64_t>( _stats._peak_closed, _closed->size() );
+            closed_bytes = std::max( closed_bytes, _closed->size_in_bytes() );
+        }
+        if (_verbose)
+            cout << "Bound " << bound << ": " << _stats._number_of_expansions - expansions
+                 << " expansions" << endl;
+        if ( _found || _stopped || _next_bound == UINT_MAX )
+            break;
+        bound = _next_bound;
+    }
+
+    for ( auto const& worker : _workers ) {
+        _stats._generated += worker->_generated;
+        _stats._heuristic_evaluations += worker->_evaluations;
+        _stats._peak_open = std::max( _stats._peak_open, worker->_peak_path );
+        _stats._tt_probes += worker->_closed_probes;
+        _stats._tt_hits += worker->_closed_hits;
+        _stats._tt_cutoffs += worker->_closed_cutoffs;
+    }
+    if ( _deadline_hit )
+        _status = search_status_t::DEADLINE;
+    else if ( _stopped )
+        _status = search_status_t::INTERRUPTED;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    _stats._elapsed_seconds = elapsed.count();
+    _stats._timeline.push_back( make_pair( _stats._elapsed_seconds, _stats._number_of_expansions ) );
+    _stats._peak_memory_estimate = _workers.size() * _stats._peak_open
+        * (sizeof(search_op_t) + sizeof(vector<search_op_t>)) + closed_bytes;
+
+    if ( _found ) {
+        _solved = true;
+        _status = search_status_t::SOLVED;
+        _solution = recover();
+    }
+    else if (_verbose) {
+        if (_status == search_status_t::DEADLINE)
+            cout << endl << "Deadline reached." << endl;
+        else if (_status == search_status_t::INTERRUPTED)
+            cout << endl << "Interrupted." << endl;
+        else
+            cout << endl << "No solution could be found." << endl;
+    }
+    return _solved;
+}
+
+void ParallelDepthFirstSearch::work( size_t id, uint bound )
+{
+    worker_t& worker = *_workers[id];
+    bool idle = false;
+    task_t task;
+    while ( !_found && !_stopped ) {
+        if ( take( id, task ) ) {
+            if ( idle ) {
+                --_idle;
+                idle = false;
+            }
+            enter( worker, task );
+            if ( search( worker, task._g, bound ) == outcome_t::FOUND )
+                break;
+            --_pending;
+            continue;
+        }
+        if ( _pending == 0 )
+            break;
+        if ( !idle ) {
+            ++_idle;
+            idle = true;
+        }
+        this_thread::yield();
+    }
+    if ( idle )
+        --_idle;
+
+    // Tasks left over by a stop or a solution are dropped.
+    lock_guard<mutex> guard { worker._lock };
+    worker._tasks.clear();
+    worker._queued = 0;
+}
+
+bool ParallelDepthFirstSearch::take( size_t id, task_t& task )
+{
+    worker_t& own = *_workers[id];
+    if ( own._queued > 0 ) {
+        lock_guard<mutex> guard { own._lock };
+        if ( !own._tasks.empty() ) {
+            task = std::move( own._tasks.back() );
+            own._tasks.pop_back();
+            --own._queued;
+            return true;
+        }
+    }
+    // Steal the shallowest task, the one with the largest subtree.
+    for ( size_t i=1; i<_workers.size(); ++i ) {
+        worker_t& other = *_workers[(id + i) % _workers.size()];
+        if ( other._queued == 0 )
+            continue;
+        lock_guard<mutex> guard { other._lock };
+        if ( !other._tasks.empty() ) {
+            task = std::move( other._tasks.front() );
+            other._tasks.pop_front();
+            --other._queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParallelDepthFirstSearch::enter( worker_t& worker, task_t const& task )
+{
+    // Undo down to the longest common prefix, then apply the rest.
+    size_t common = 0;
+    while ( common < worker._path.size() && common < task._path.size()
+        && worker._path[common]._kind == task._path[common]._kind
+        && worker._path[common]._from == task._path[common]._from
+        && worker._path[common]._to == task._path[common]._to )
+        ++common;
+    while ( worker._path.size() > common ) {
+        worker._state.undo( worker._path.back() );
+        worker._path.pop_back();
+    }
+    for ( size_t i=common; i<task._path.size(); ++i ) {
+        worker._state.apply( task._path[i] );
+        worker._path.push_back( task._path[i] );
+    }
+}
+
+ParallelDepthFirstSearch::outcome_t ParallelDepthFirstSearch::search( worker_t& worker, uint g, uint bound )
+{
+    ++worker._evaluations;
+    uint f = g + worker._state.heuristic();
+    if ( f > bound ) {
+        uint next = _next_bound.load( memory_order_relaxed );
+        while ( f < next && !_next_bound.compare_exchange_weak( next, f ) )
+            ;
+        return outcome_t::NOT_FOUND;
+    }
+    if ( worker._state.is_final() ) {
+        bool expected = false;
+        if ( _found.compare_exchange_strong( expected, true ) ) {
+            _stats._solution_cost = g;
+            _solution_path = worker._path;
+        }
+        return outcome_t::FOUND;
+    }
+    if ( _found.load( memory_order_relaxed ) || _stopped.load( memory_order_relaxed ) )
+        return outcome_t::STOPPED;
+    if ( _has_deadline && (++worker._deadline_countdown % DEADLINE_CHECK_PERIOD) == 0
+        && std::chrono::steady_clock::now() > _deadline ) {
+        _deadline_hit = true;
+        _stopped = true;
+        return outcome_t::STOPPED;
+    }
+    if ( _stop_requested ) {
+        _stopped = true;
+        return outcome_t::STOPPED;
+    }
+
+    if ( _closed ) {
+        ++worker._closed_probes;
+        ConcurrentClosedTable::result_t seen = _closed->insert_or_decrease( worker._state.hash(), g );
+        if ( seen != ConcurrentClosedTable::result_t::INSERTED )
+            ++worker._closed_hits;
+        if ( seen == ConcurrentClosedTable::result_t::NOT_DECREASED ) {
+            ++worker._closed_cutoffs;
+            return outcome_t::NOT_FOUND;
+        }
+    }
+
+    ++worker._expansions;
+    size_t depth = worker._path.size();
+    // Stolen tasks start deeper than the path searched so far.
+    if ( worker._operators.size() <= depth )
+        worker._operators.resize( depth + 1 );
+    worker._state.operators( worker._operators[depth] );
+
+    for ( size_t i=0; i<worker._operators[depth].size(); ++i ) {
+        search_op_t op = worker._operators[depth][i];
+        // Going straight back costs more than not leaving.
+        if ( op._kind == search_op_t::TRANSIT && !worker._path.empty()
+            && worker._path.back()._kind == search_op_t::TRANSIT && worker._path.back()._from == op._to )
+            continue;
+
+        // Someone is out of work: queue the rest for them, the
+        // first successor last so this thread goes on with it.
+        if ( _idle.load( memory_order_relaxed ) > 0 && worker._queued.load( memory_order_relaxed ) == 0 ) {
+            vector<task_t> split;
+            for ( size_t j=worker._operators[depth].size(); j-- > i; ) {
+                search_op_t rest = worker._operators[depth][j];
+                if ( rest._kind == search_op_t::TRANSIT && !worker._path.empty()
+                    && worker._path.back()._kind == search_op_t::TRANSIT && worker._path.back()._from == rest._to )
+                    continue;
+                ++worker._generated;
+                split.push_back( task_t { worker._path, g + rest._cost } );
+                split.back()._path.push_back( rest );
+            }
+            _pending += split.size();
+            lock_guard<mutex> guard { worker._lock };
+            for ( task_t& task : split )
+                worker._tasks.push_back( std::move(task) );
+            worker._queued += split.size();
+            return outcome_t::NOT_FOUND;
+        }
+
+        ++worker._generated;
+        worker._state.apply( op );
+        worker._path.push_back( op );
+        worker._peak_path = std::max<uint64_t>( worker._peak_path, worker._path.size() );
+        outcome_t outcome = search( worker, g + op._cost, bound );
+        if ( outcome == outcome_t::FOUND )
+            return outcome;
+        worker._path.pop_back();
+        worker._state.undo( op );
+        if ( outcome == outcome_t::STOPPED )
+            return outcome;
+    }
+    return outcome_t::NOT_FOUND;
+}
+
+string ParallelDepthFirstSearch::recover()
+{
+    vector<expanded_t> ordered_recovery;
+    for ( auto op = _solution_path.rbegin(); op != _solution_path.rend(); ++op ) {
+        ordered_recovery.push_back( expanded_t (
+            0, 0,
+            op->_to,
+            op->_kind == search_op_t::EMBARK,
+            op->_kind == search_op_t::DISEMBARK,
+            op->_kind == search_op_t::EMBARK ? _initial.destination(op->_from) : 0 ) );
+    }
+    ordered_recovery.push_back( expanded_t(0, 0, _initial_station, false, false, 0) );
+    return format_route( ordered_recovery );
+}
@@ -0,0 +1,119 @@
+#ifndef PARALLELDEPTHFIRSTSEARCH_H
+#define PARALLELDEPTHFIRSTSEARCH_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ConcurrentClosedTable.h"
+#include "Graph.h"
+#include "SearchEngine.h"
+#include "SearchState.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    IDA* on several threads. Every iteration is split into tasks,
+    each the operators from the initial state to the root of a
+    subtree, which threads search depth-first as DepthFirstSearch
+    does, on a SearchState of their own.
+
+    Every thread has a deque of tasks: it takes the deepest one
+    from its own, and when it runs out steals the shallowest one
+    of another. While some thread is idle, a thread expanding a
+    state with nothing queued hands the rest of its successors
+    over as tasks instead of searching them, so subtrees are only
+    split when needed.
+
+    The next bound is the minimum of what every thread pruned.
+    All solutions with a lower cost were ruled out by the earlier
+    iterations, so the first one found is optimal and stops every
+    thread.
+
+    Threads share a closed table, emptied every iteration, of the
+    cheapest g each configuration was reached with. A state reached
+    as cheaply before, by any thread, is pruned: the subtree under
+    the cheaper copy holds everything under it.
+*/
+class ParallelDepthFirstSearch : public SearchEngine
+{
+public:
+    /**
+        Same arguments as Solver, and the number of threads.
+    */
+    ParallelDepthFirstSearch( Graph const * graph, vector<school_t> schools,
+        vector<station_t>& stations, bus_t& bus,
+        heuristic_t heuristic, string filename, uint threads );
+
+    bool solve() override;
+
+    /* Search without the shared closed table. */
+    void set_shared_closed( bool enabled ) { _use_closed = enabled; }
+
+private:
+    enum class outcome_t { FOUND, NOT_FOUND, STOPPED };
+
+    /* Root of a subtree to search. */
+    typedef struct task_t
+    {
+        vector<search_op_t> _path;
+        uint _g;
+    } task_t;
+
+    typedef struct worker_t
+    {
+        worker_t( SearchState const& state ) : _state { state } {}
+
+        SearchState _state;
+        /* Operators from the initial state to the current one. */
+        vector<search_op_t> _path;
+        vector< vector<search_op_t> > _operators;
+
+        mutex _lock;
+        deque<task_t> _tasks;
+        std::atomic<size_t> _queued { 0 };
+
+        uint _deadline_countdown    = 0;
+        uint64_t _expansions        = 0;
+        uint64_t _generated         = 0;
+        uint64_t _evaluations       = 0;
+        uint64_t _peak_path         = 0;
+        uint64_t _closed_probes     = 0;
+        uint64_t _closed_hits       = 0;
+        uint64_t _closed_cutoffs    = 0;
+    } worker_t;
+
+    SearchState _initial;
+    uint _initial_station;
+    vector< unique_ptr<worker_t> > _workers;
+
+    /* Tasks queued or being searched in the current iteration. */
+    std::atomic<size_t> _pending { 0 };
+    std::atomic<uint> _idle { 0 };
+    std::atomic<uint> _next_bound { 0 };
+    std::atomic<bool> _found { false };
+    std::atomic<bool> _stopped { false };
+    std::atomic<bool> _deadline_hit { false };
+    vector<search_op_t> _solution_path;
+
+    bool _use_closed                = true;
+    unique_ptr<ConcurrentClosedTable> _closed;
+
+    /* Search tasks until the iteration bounded by 'bound' ends. */
+    void work( size_t id, uint bound );
+
+    /* Take a task of worker 'id', or steal one. */
+    bool take( size_t id, task_t& task );
+
+    /* Move the state of 'worker' to the root of 'task'. */
+    void enter( worker_t& worker, task_t const& task );
+
+    outcome_t search( worker_t& worker, uint g, uint bound );
+
+    string recover();
+};
+
+#endif
@@ -0,0 +1,266 @@
+#include "Parser.h"
+#include <charconv>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+bool is_blank( char c )
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+    Cursor over the lines of the input buffer.
+    Blank lines are skipped.
+*/
+class line_reader
+{
+public:
+    line_reader( string_view text )
+    : _text { text }
+    , _pos { 0 }
+    , _line_number { 0 }
+    {}
+
+    bool next( string_view& line )
+    {
+        while ( _pos < _text.size() ) {
+            size_t end = _text.find('\n', _pos);
+            if ( end == string_view::npos )
+                end = _text.size();
+            line = _text.substr(_pos, end - _pos);
+            _pos = end + 1;
+            ++_line_number;
+
+            for ( char c : line ) {
+                if ( !is_blank(c) )
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    string_view require( const char* what )
+    {
+        string_view line;
+        if ( !next(line) )
+            throw runtime_error( string("unexpected end of input, expected ") + what );
+        return line;
+    }
+
+    size_t line_number() const { return _line_number; }
+
+private:
+    string_view _text;
+    size_t _pos;
+    size_t _line_number;
+};
+
+/**
+    Return the next blank separated token of 'line' and
+    advance it past the token. Returns an empty view at the end.
+*/
+string_view next_token( string_view& line )
+{
+    size_t i = 0;
+    while ( i < line.size() && is_blank(line[i]) ) ++i;
+    size_t j = i;
+    while ( j < line.size() && !is_blank(line[j]) ) ++j;
+    string_view token = line.substr(i, j - i);
+    line.remove_prefix(j);
+    return token;
+}
+
+/**
+    Return the next 'splt' separated field of 'line' and advance
+    it past the separator.
+*/
+string_view next_field( string_view& line, char splt )
+{
+    size_t end = line.find(splt);
+    string_view field = line.substr(0, end);
+    line.remove_prefix( end == string_view::npos ? line.size() : end + 1 );
+    return field;
+}
+
+bool is_empty_field( string_view field )
+{
+    for ( char c : field ) {
+        if ( !is_blank(c) )
+            return false;
+    }
+    return true;
+}
+
+/**
+    Extract the digit runs of 'str' in order into 'result'.
+    Example: ' C2: P3' -> [2, 3]
+    Returns the number of values extracted.
+*/
+size_t extract_numbers( string_view str, uint* result, size_t max_values )
+{
+    size_t count = 0;
+    const char* it = str.data();
+    const char* end = str.data() + str.size();
+    while ( it < end && count < max_values ) {
+        if ( *it < '0' || *it > '9' ) {
+            ++it;
+            continue;
+        }
+        auto parsed = from_chars(it, end, result[count]);
+        if ( parsed.ec != errc() )
+            throw runtime_error( "number out of range: '" + string(str) + "'" );
+        it = parsed.ptr;
+        ++count;
+    }
+    return count;
+}
+
+void require_numbers( string_view str, uint* result, size_t expected, size_t line_number )
+{
+    if ( extract_numbers(str, result, expected) != expected )
+        throw runtime_error( "line " + to_string(line_number) +
+            ": malformed entry '" + string(str) + "'" );
+}
+
+int find_school_station( uint school_id, const vector<school_t>& schools )
+{
+    for ( const school_t& school : schools ) {
+        if ( school._id == school_id )
+            return static_cast<int>(school._station_id);
+    }
+    return -1;
+}
+
+} // namespace
+
+
+problem_t parse_problem( string_view text )
+{
+    problem_t problem;
+    line_reader lines { text };
+
+    /* Station header: "P1 P2 ... Pn" */
+    string_view header = lines.require("station header");
+    size_t node_count = 0;
+    while ( !next_token(header).empty() )
+        ++node_count;
+    if ( node_count == 0 )
+        throw runtime_error( "no stations defined" );
+
+    /* Cost matrix, a row per station prefixed by its name. */
+    vector<Edge> graph_edges;
+    for ( uint i=1; i<=node_count; ++i ) {
+        string_view row = lines.require("cost matrix row");
+        next_token(row); // Row label.
+        for ( uint j=1; j<=node_count; ++j ) {
+            string_view cost = next_token(row);
+            if ( cost.empty() )
+                throw runtime_error( "line " + to_string(lines.line_number()) +
+                    ": expected " + to_string(node_count) + " costs" );
+            if ( cost == "--" )
+                continue;
+
+            uint value = 0;
+            auto parsed = from_chars(cost.data(), cost.data() + cost.size(), value);
+            if ( parsed.ec != errc() || parsed.ptr != cost.data() + cost.size() )
+                throw runtime_error( "line " + to_string(lines.line_number()) +
+                    ": invalid cost '" + string(cost) + "'" );
+            graph_edges.push_back( Edge(i, j, value) );
+        }
+    }
+    problem.graph = Graph { graph_edges, node_count };
+
+    /* Schools: "C1: P6; C2: P3" */
+    string_view schools = lines.require("school list");
+    while ( !schools.empty() ) {
+        string_view school = next_field(schools, ';');
+        if ( is_empty_field(school) )
+            continue;
+        uint num[2];
+        require_numbers(school, num, 2, lines.line_number());
+        problem.schools.push_back( school_t(num[0], num[1]) );
+    }
+
+    /* Waiting passengers: "P2: 1 C2, 1 C3; P4: 1 C3" */
+    for ( uint i=0; i<node_count; ++i )
+        problem.stations.push_back( station_t(i + 1) );
+
+    string_view stations = lines.require("passenger list");
+    while ( !stations.empty() ) {
+        string_view station = next_field(stations, ';');
+        if ( is_empty_field(station) )
+            continue;
+
+        uint station_id = 0;
+        require_numbers( next_field(station, ':'), &station_id, 1, lines.line_number() );
+        if ( station_id == 0 || station_id > node_count )
+            throw runtime_error( "unknown station P" + to_string(station_id) );
+
+        while ( !station.empty() ) {
+            string_view passengers = next_field(station, ',');
+            if ( is_empty_field(passengers) )
+                continue;
+            // Number of passengers and the school they are going to.
+            uint values[2];
+            require_numbers(passengers, values, 2, lines.line_number());
+            int destination_station = find_school_station(values[1], problem.schools);
+            if ( destination_station < 0 )
+                throw runtime_error( "unknown school C" + to_string(values[1]) );
+
+            for ( uint p=0; p<values[0]; ++p ) {
+                problem.stations[station_id-1]._passengers.push_back(
+                    passenger_t( station_id, static_cast<uint>(destination_station) ) );
+            }
+        }
+    }
+
+    /* Bus: "B: P1 5" */
+    string_view bus = lines.require("bus definition");
+    next_field(bus, ':');
+    uint features[2];
+    require_numbers(bus, features, 2, lines.line_number());
+    if ( features[0] == 0 || features[0] > node_count )
+        throw runtime_error( "unknown bus origin P" + to_string(features[0]) );
+    problem.bus._origin_station  = features[0];
+    problem.bus._current_station = features[0];
+    problem.bus._max_passengers  = features[1];
+
+    return problem;
+}
+
+problem_t parse_problem_file( const string& path )
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if ( fd < 0 )
+        throw runtime_error( "cannot open " + path );
+
+    struct stat info;
+    if ( fstat(fd, &info) != 0 || info.st_size == 0 ) {
+        close(fd);
+        throw runtime_error( "cannot read " + path );
+    }
+
+    size_t length = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if ( data == MAP_FAILED )
+        throw runtime_error( "cannot map " + path );
+    madvise(data, length, MADV_SEQUENTIAL);
+
+    try {
+        problem_t problem = parse_problem( string_view(static_cast<const char*>(data), length) );
+        munmap(data, length);
+        return problem;
+    }
+    catch (...) {
+        munmap(data, length);
+        throw;
+    }
+}
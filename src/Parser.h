@@ -0,0 +1,55 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Graph.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    Everything a '.probl' file defines: the map of stations,
+    the schools, the passengers waiting at every station and
+    the bus features.
+*/
+typedef struct problem_t
+{
+    problem_t()
+    : graph { vector<Edge>(), 0 }
+    , schools {}
+    , stations {}
+    , bus {}
+    {}
+
+    Graph graph;
+    vector<school_t> schools;
+    vector<station_t> stations;
+    bus_t bus;
+
+} problem_t;
+
+/**
+    Single pass parser for the '.probl' text format.
+
+        P1 P2 P3 ...                  <- station header
+        P1 -- 12 -- ...               <- one cost row per station
+        C1: P6; C2: P3                <- schools
+        P2: 1 C2, 1 C3; P4: 1 C3      <- waiting passengers
+        B: P1 5                       <- bus origin and capacity
+
+    The text is tokenized in place with string views, so no
+    temporary strings are built while reading the cost matrix.
+
+    Throws runtime_error if the text is malformed.
+*/
+problem_t parse_problem( string_view text );
+
+/**
+    Map the file into memory and parse it with 'parse_problem'.
+    Throws runtime_error if the file cannot be read or is malformed.
+*/
+problem_t parse_problem_file( const string& path );
+
+#endif
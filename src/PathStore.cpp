@@ -0,0 +1,74 @@
+#include "PathStore.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const uint32_t KIND_TRANSIT     = 0;
+const uint32_t KIND_EMBARK      = 1;
+const uint32_t KIND_DISEMBARK   = 2;
+
+} // namespace
+
+PathStore::PathStore( size_t stations, vector<school_t> const& schools )
+: _records {}
+, _schools { schools }
+{
+    if ( stations >= (1u << STATION_BITS) )
+        throw runtime_error( "too many stations for the path store" );
+    if ( schools.size() >= (1u << SCHOOL_BITS) )
+        throw runtime_error( "too many schools for the path store" );
+}
+
+uint32_t PathStore::append( uint32_t parent, expanded_t const& expansion )
+{
+    _records.push_back( path_record_t { parent, pack_action(expansion) } );
+    return static_cast<uint32_t>(_records.size() - 1);
+}
+
+vector<expanded_t> PathStore::path_to( uint32_t index ) const
+{
+    vector<expanded_t> path;
+    while ( index != NO_PARENT ) {
+        path.push_back( unpack_action(_records[index]._action) );
+        index = _records[index]._parent;
+    }
+    return path;
+}
+
+size_t PathStore::size() const { return _records.size(); }
+
+vector<path_record_t> const& PathStore::records() const { return _records; }
+
+void PathStore::restore( vector<path_record_t> records ) { _records.swap(records); }
+
+uint32_t PathStore::pack_action( expanded_t const& expansion ) const
+{
+    uint32_t kind = expansion._embarking ? KIND_EMBARK
+        : (expansion._disembarking ? KIND_DISEMBARK : KIND_TRANSIT);
+
+    uint32_t school = 0;
+    if ( expansion._embarking ) {
+        for ( size_t i=0; i<_schools.size(); ++i ) {
+            if ( _schools[i]._station_id == expansion._school_destination ) {
+                school = static_cast<uint32_t>(i);
+                break;
+            }
+        }
+    }
+    return kind | (expansion._station_id << 2) | (school << (2 + STATION_BITS));
+}
+
+expanded_t PathStore::unpack_action( uint32_t action ) const
+{
+    uint32_t kind = action & 3;
+    uint station = (action >> 2) & ((1u << STATION_BITS) - 1);
+    uint32_t school = action >> (2 + STATION_BITS);
+    return expanded_t (
+        0, 0,
+        station,
+        kind == KIND_EMBARK,
+        kind == KIND_DISEMBARK,
+        kind == KIND_EMBARK ? _schools[school]._station_id : 0 );
+}
@@ -0,0 +1,77 @@
+#ifndef PATHSTORE_H
+#define PATHSTORE_H
+
+#include <cstdint>
+#include <vector>
+#include "ClosedSet.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    A step of a search path: the index of the record of the
+    previous step and the action that led to this one.
+*/
+typedef struct path_record_t
+{
+    uint32_t _parent;
+    uint32_t _action;
+} path_record_t;
+
+/**
+    Append only log of the paths of the expanded nodes. Every
+    expanded node adds a record, addressed by its position, that
+    points to the record of its parent, so the path of any node
+    is a walk over one contiguous array and the closed list only
+    needs the node IDs.
+
+    Actions are packed in 32 bits:
+
+        [kind: 2] [station: 20] [school index: 10]
+
+    where the school is the one an embarking passenger goes to.
+*/
+class PathStore
+{
+public:
+    /**
+        Throws runtime_error if the problem has too many stations
+        or schools to pack its actions.
+    */
+    PathStore( size_t stations, vector<school_t> const& schools );
+
+    /**
+        Store the step 'expansion' taken after record 'parent' and
+        return its index. The initial state has parent NO_PARENT.
+    */
+    uint32_t append( uint32_t parent, expanded_t const& expansion );
+
+    /**
+        Steps from record 'index' back to the initial state, in
+        that order, with station, flags and school destination
+        filled in.
+    */
+    vector<expanded_t> path_to( uint32_t index ) const;
+
+    size_t size() const;
+
+    vector<path_record_t> const& records() const;
+
+    /* Replace the log, as restored from a checkpoint. */
+    void restore( vector<path_record_t> records );
+
+    uint32_t pack_action( expanded_t const& expansion ) const;
+
+    expanded_t unpack_action( uint32_t action ) const;
+
+    static const uint32_t NO_PARENT = UINT32_MAX;
+
+    static const uint32_t STATION_BITS = 20;
+    static const uint32_t SCHOOL_BITS = 10;
+
+private:
+    vector<path_record_t> _records;
+    vector<school_t> _schools;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "Profiler.h"
+
+#ifdef BUS_ROUTING_PROFILE
+
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+
+thread_local profile_counters_t profile_counters;
+
+namespace {
+
+const char* PHASE_NAMES[PHASE_COUNT] = {
+    "successors",
+    "hash",
+    "heuristic",
+    "open list",
+    "closed list"
+};
+
+thread_local uint64_t reset_ticks = 0;
+thread_local chrono::steady_clock::time_point reset_time;
+
+} // namespace
+
+void profiler_reset()
+{
+    profile_counters = profile_counters_t {};
+    reset_time = chrono::steady_clock::now();
+    reset_ticks = profile_ticks();
+}
+
+void profiler_report( ostream& out )
+{
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - reset_time;
+    uint64_t ticks = profile_ticks() - reset_ticks;
+    double seconds_per_tick = ticks != 0 ? elapsed.count() / ticks : 0;
+
+    out << "Profile (" << elapsed.count() << " s, phases nest: hash is part of successors)" << endl;
+    out << left << setw(14) << "phase" << right
+        << setw(14) << "calls"
+        << setw(14) << "seconds"
+        << setw(10) << "% run"
+        << setw(14) << "ns/call" << endl;
+    for ( int phase = 0; phase < PHASE_COUNT; ++phase ) {
+        double seconds = profile_counters._ticks[phase] * seconds_per_tick;
+        uint64_t calls = profile_counters._calls[phase];
+        out << left << setw(14) << PHASE_NAMES[phase] << right
+            << setw(14) << calls
+            << setw(14) << fixed << setprecision(4) << seconds
+            << setw(10) << setprecision(1) << (elapsed.count() > 0 ? 100 * seconds / elapsed.count() : 0)
+            << setw(14) << setprecision(1) << (calls != 0 ? 1e9 * seconds / calls : 0)
+            << defaultfloat << endl;
+    }
+}
+
+#endif
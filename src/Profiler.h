@@ -0,0 +1,96 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <ostream>
+
+using namespace std;
+
+/**
+    Scoped timers for the phases of the search loop, enabled by 
+    building with BUS_ROUTING_PROFILE defined (the CMake option of 
+    the same name). Otherwise every PROFILE_* macro expands to 
+    nothing and costs nothing.
+
+    Time is read from the time stamp counter where available and 
+    accumulated per thread, so concurrent searches do not share 
+    counters. Phases nest: 'hash' time is also part of 'successors'.
+*/
+enum profile_phase_t
+{
+    PHASE_SUCCESSORS,
+    PHASE_HASH,
+    PHASE_HEURISTIC,
+    PHASE_OPEN_LIST,
+    PHASE_CLOSED_LIST,
+    PHASE_COUNT
+};
+
+#ifdef BUS_ROUTING_PROFILE
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+inline uint64_t profile_ticks() { return __rdtsc(); }
+#else
+#include <chrono>
+inline uint64_t profile_ticks()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+typedef struct profile_counters_t
+{
+    uint64_t _ticks[PHASE_COUNT];
+    uint64_t _calls[PHASE_COUNT];
+} profile_counters_t;
+
+extern thread_local profile_counters_t profile_counters;
+
+class profile_scope_t
+{
+public:
+    profile_scope_t( profile_phase_t phase )
+    : _phase { phase }
+    , _start { profile_ticks() }
+    {}
+
+    ~profile_scope_t()
+    {
+        profile_counters._ticks[_phase] += profile_ticks() - _start;
+        ++profile_counters._calls[_phase];
+    }
+
+private:
+    profile_phase_t _phase;
+    uint64_t _start;
+};
+
+/**
+    Clear the counters of the calling thread and start the clock 
+    used to convert ticks to seconds.
+*/
+void profiler_reset();
+
+/**
+    Print the time spent per phase by the calling thread since 
+    the last 'profiler_reset'.
+*/
+void profiler_report( ostream& out );
+
+#define PROFILE_CONCAT_( a, b ) a##b
+#define PROFILE_CONCAT( a, b ) PROFILE_CONCAT_( a, b )
+#define PROFILE_SCOPE( phase ) profile_scope_t PROFILE_CONCAT( profile_scope_, __LINE__ ) { phase }
+#define PROFILE_RESET() profiler_reset()
+#define PROFILE_REPORT( out ) profiler_report( out )
+
+#else
+
+#define PROFILE_SCOPE( phase )
+#define PROFILE_RESET()
+#define PROFILE_REPORT( out )
+
+#endif
+
+#endif
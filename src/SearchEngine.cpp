@@ -0,0 +1,186 @@
+#include "SearchEngine.h"
+#include <fstream>
+#include <sstream>
+#include "assert.h"
+
+using namespace std;
+
+/**
+The solution should contain the path to follow by the bus to take all students to their
+schools and returning to the initial bus stop. 
+
+It should show up first, the input problem and immediately after the route to follow. 
+
+For instance P1 → P2 (S: 1 C2, 1 C3) → P3 (B: 1 C2) → · · · → P1 means that the school bus
+starts its journey from bus stop P1. It goes first to bus stop P2 where one student going to
+school C2 , and another going to school C3 get into the bus (and this is denoted by using the 
+prefix S).
+
+Next, it goes to bus stop P3 where one student going to school C2 gets off the bus —denoted with the
+letter B. At the end, the bus returns to its initial location.
+
+*/
+string SearchEngine::format_route( vector<expanded_t> const& ordered_recovery )
+{
+    string solution = "";
+
+    // Now parse the recovered path into a string.
+    // We will do this via a finite state machine to identify the type of state.
+    bool previous_parentesis = false;
+    bool first = true;
+    for ( long i = static_cast<long>(ordered_recovery.size())-1; i >= 0 ; --i ) {
+        /* First we need to determine what type of operation was done. */
+        if ( !ordered_recovery[i]._embarking && !ordered_recovery[i]._disembarking ) {
+            // Then we have a transition to another station.
+            ++_stats._number_of_stops;
+            if (previous_parentesis) {
+                solution += ") ";
+                previous_parentesis = false;
+            }
+            if (first) {
+                solution += "P" + to_string( ordered_recovery[i]._station_id ) + " ";
+                first = false;
+            }
+            else
+                solution += "->P" + to_string( ordered_recovery[i]._station_id ) + " ";
+        }
+        else if ( ordered_recovery[i]._embarking && !ordered_recovery[i]._disembarking ) {
+            // Then we have an embarkation of a passenger into the bus. 
+            int school_id = parse_school(ordered_recovery[i]._school_destination);
+            ostringstream sid;
+            sid << school_id;
+            string sch_id = sid.str();
+            if (previous_parentesis)
+                solution += ", 1 C" + sch_id; 
+            else {
+                if (first) 
+                    solution += "->P" + to_string( ordered_recovery[i]._station_id ) + " ";
+                
+                solution += "(S: 1 C" + sch_id;
+                previous_parentesis = true;
+            }
+        }
+        else if ( !ordered_recovery[i]._embarking && ordered_recovery[i]._disembarking ) {
+            // Then we have a disembarking of a passenger into the station.
+            int school_id = parse_school(ordered_recovery[i]._station_id);
+            ostringstream sid;
+            sid << school_id;
+            string sch_id = sid.str();
+            if (previous_parentesis)
+                solution += ", 1 C" + sch_id;
+            else {
+                if (first) 
+                    solution += "->P" + to_string( ordered_recovery[i]._station_id ) + " ";
+                solution += "(B: 1 C" + sch_id;
+                previous_parentesis = true;
+            }
+        }
+        else {
+            assert (1!=1 && "ERROR: Unreachable state");
+        }
+    }
+
+    // Done 
+    return solution;
+}
+
+int SearchEngine::parse_school( uint station_id) 
+{
+    for (school_t school: _schools) {
+        if ( school._station_id == station_id )
+            return static_cast<int>(school._id);
+    }
+    return -1;
+}
+
+
+/**
+    Statistics file. 
+    This file should contain various data about the search process such as 
+    the overall running time, overall cost, step length, number of expansions, etc. 
+    An example is shown below:
+    
+        Overall time: 145
+        Overall cost: 54
+        # Stops: 27
+        # Expansions: 132
+    
+    The name of this file should be suffixed with .statistics.
+        Example: problem.prob.statistics
+
+*/
+void SearchEngine::write_stats_file() 
+{
+    ofstream stats_file;
+    stats_file.open(_filename+".statistics");
+    stats_file << stats_to_str();
+    stats_file.close();
+}
+
+string SearchEngine::stats_to_str() const
+{
+    return _stats.to_str();
+}
+
+void SearchEngine::write_json_stats_file()
+{
+    ofstream stats_file;
+    stats_file.open(_filename+".statistics.json");
+    stats_file << _stats.to_json( status_to_str(_status) );
+    stats_file.close();
+}
+
+void SearchEngine::write_down_solution_file()
+{
+    if (_solved) {
+        ofstream solution_file;
+        solution_file.open(_filename+".output");
+        solution_file << _solution << endl;
+        solution_file.close();
+    }
+}
+
+void SearchEngine::set_memory_limit( size_t bytes ) { _memory_limit = bytes; }
+
+void SearchEngine::set_verbose( bool verbose ) { _verbose = verbose; }
+
+void SearchEngine::set_deadline( std::chrono::steady_clock::time_point deadline )
+{
+    _deadline = deadline;
+    _has_deadline = true;
+}
+
+void SearchEngine::request_stop() { _stop_requested = true; }
+
+bool SearchEngine::deadline_passed()
+{
+    return _has_deadline && (++_deadline_countdown % DEADLINE_CHECK_PERIOD) == 0
+        && std::chrono::steady_clock::now() > _deadline;
+}
+
+search_status_t SearchEngine::get_status() const { return _status; }
+
+string SearchEngine::get_solution() const { return _solution; }
+
+uint SearchEngine::get_solution_cost() const { return _stats._solution_cost; }
+
+uint64_t SearchEngine::get_number_of_stops() const { return _stats._number_of_stops; }
+
+uint64_t SearchEngine::get_number_of_expansions() const { return _stats._number_of_expansions; }
+
+double SearchEngine::get_elapsed_seconds() const { return _stats._elapsed_seconds; }
+
+search_stats_t const& SearchEngine::get_stats() const { return _stats; }
+
+string status_to_str( search_status_t status )
+{
+    switch (status) {
+        case search_status_t::NOT_STARTED:  return "not_started";
+        case search_status_t::SOLVED:       return "solved";
+        case search_status_t::EXHAUSTED:    return "no_solution";
+        case search_status_t::MEMORY_LIMIT: return "memory_limit";
+        case search_status_t::DEADLINE:     return "deadline";
+        case search_status_t::INTERRUPTED:  return "interrupted";
+    }
+    return "unknown";
+}
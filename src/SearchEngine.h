@@ -0,0 +1,146 @@
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Types.h"
+#include "ClosedSet.h"
+#include "SearchStats.h"
+
+using namespace std;
+
+/**
+    Reason why a search stopped.
+*/
+enum class search_status_t
+{
+    NOT_STARTED,
+    SOLVED,
+    EXHAUSTED,      /* Open list emptied without a solution. */
+    MEMORY_LIMIT,   /* Estimated memory use went over the limit. */
+    DEADLINE,       /* Ran past the deadline. */
+    INTERRUPTED     /* Stopped by 'request_stop'. */
+};
+
+string status_to_str( search_status_t status );
+
+/**
+    Everything the search algorithms have in common: the limits
+    they run under, their statistics and the '.output' and
+    '.statistics' files they write.
+
+    Subclasses implement 'solve' and fill '_solution', '_status'
+    and '_stats'.
+*/
+class SearchEngine
+{
+public:
+    SearchEngine( vector<school_t> schools, string filename )
+    : _schools { schools }
+    , _filename { filename }
+    {}
+
+    virtual ~SearchEngine() {}
+
+    /**
+        Run until a solution is found, the search space is
+        exhausted or a limit is hit. Return true if solved.
+    */
+    virtual bool solve() = 0;
+
+    /**
+        Write down in a file statistics of the search task.
+            - Overall running time.
+            - Number of expansions.
+            - Overall cost of the solution.
+            - Solution length.
+    */
+    void write_stats_file();
+
+    /**
+        Contents of the statistics file.
+    */
+    string stats_to_str() const;
+
+    /**
+        Write down every counter of the search as JSON,
+        suffixed with '.statistics.json'.
+    */
+    void write_json_stats_file();
+
+    search_stats_t const& get_stats() const;
+
+    /**
+        Write down the solution if available.
+    */
+    void write_down_solution_file();
+
+    /**
+        Stop the search once the open and closed lists are
+        estimated to use more than 'bytes'. Zero means no limit.
+    */
+    void set_memory_limit( size_t bytes );
+
+    /**
+        Print progress to the standard output. Enabled by default.
+    */
+    void set_verbose( bool verbose );
+
+    /**
+        Give up the search once 'deadline' has passed.
+    */
+    void set_deadline( std::chrono::steady_clock::time_point deadline );
+
+    /**
+        Ask a running search to stop as soon as possible.
+        Safe to call from a signal handler or another thread.
+    */
+    void request_stop();
+
+    search_status_t get_status() const;
+    string          get_solution() const;
+    uint            get_solution_cost() const;
+    uint64_t        get_number_of_stops() const;
+    uint64_t        get_number_of_expansions() const;
+    double          get_elapsed_seconds() const;
+
+    /* Iterations between clock reads when a deadline is set. */
+    static const uint DEADLINE_CHECK_PERIOD = 256;
+
+protected:
+    vector<school_t> _schools;
+    string _filename;
+    string _solution;
+    bool _solved                    = false;
+
+    /* Limits and output */
+    search_status_t _status         = search_status_t::NOT_STARTED;
+    size_t _memory_limit            = 0;
+    bool _verbose                   = true;
+    bool _has_deadline              = false;
+    std::chrono::steady_clock::time_point _deadline;
+    uint _deadline_countdown        = 0;
+    std::atomic<bool> _stop_requested { false };
+
+    /* Statistics */
+    search_stats_t _stats;
+
+    /**
+        True once the deadline has passed. The clock is only
+        read every DEADLINE_CHECK_PERIOD calls.
+    */
+    bool deadline_passed();
+
+    /**
+        Turn a path, ordered from the final node back to the
+        initial one, into the route string of the '.output'
+        file. Counts the stops into '_stats'.
+    */
+    string format_route( vector<expanded_t> const& ordered_recovery );
+
+    int parse_school( uint station_id );
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "SearchState.h"
+#include <algorithm>
+#include <random>
+
+using namespace std;
+
+namespace {
+
+/* Fixed, so hashes are the same from run to run. */
+const uint64_t ZOBRIST_SEED = 0x9e3779b97f4a7c15ull;
+
+} // namespace
+
+SearchState::SearchState( Graph const* graph, vector<station_t> const& stations, bus_t const& bus,
+    heuristic_t heuristic )
+: _graph { graph }
+, _classes { compact_classes( stations, bus ) }
+, _station_count { stations.size() }
+, _origin_station { bus._origin_station }
+, _capacity { bus._max_passengers }
+, _deliver { heuristic == heuristic_t::ALL || heuristic == heuristic_t::MAX_DISTANCE_PASSENGER }
+, _collect { heuristic == heuristic_t::ALL || heuristic == heuristic_t::MAX_DISTANCE_STATION }
+, _station { bus._current_station }
+, _on_board_total { 0 }
+, _waiting ( _classes.size(), 0 )
+, _on_board ( _classes.size(), 0 )
+, _waiting_at ( stations.size() + 1, 0 )
+, _going_to ( stations.size() + 1, 0 )
+, _waiting_stations ( stations.size() / 64 + 1, 0 )
+, _destinations ( stations.size() / 64 + 1, 0 )
+, _waiting_total { 0 }
+, _hash { 0 }
+{
+    for ( uint station=1; station<=_station_count; ++station )
+        _neighbors.push_back( graph->getNeighbors(station) );
+
+    _stride = 1;
+    for ( compact_class_t const& passenger_class : _classes )
+        _stride = std::max( _stride, passenger_class._count + 1 );
+
+    mt19937_64 random ( ZOBRIST_SEED );
+    for ( size_t i=0; i<=_station_count; ++i )
+        _station_keys.push_back( random() );
+    for ( size_t i=0; i<_classes.size() * _stride; ++i ) {
+        _waiting_keys.push_back( random() );
+        _on_board_keys.push_back( random() );
+    }
+
+    _hash = _station_keys[_station];
+    for ( size_t c=0; c<_classes.size(); ++c ) {
+        _hash ^= _waiting_keys[c * _stride] ^ _on_board_keys[c * _stride];
+        uint on_board = 0;
+        for ( passenger_t const& passenger : bus._passengers )
+            if ( passenger._origin_id == _classes[c]._origin && passenger._destination_id == _classes[c]._destination )
+                ++on_board;
+        add_waiting( c, _classes[c]._count - on_board );
+        add_on_board( c, on_board );
+    }
+}
+
+void SearchState::operators( vector<search_op_t>& ops ) const
+{
+    ops.clear();
+    for ( Transition const& trip : _neighbors[_station - 1] )
+        ops.push_back( search_op_t { search_op_t::TRANSIT, _station, trip.destination, trip.cost } );
+
+    for ( size_t c=0; c<_classes.size(); ++c )
+        if ( _on_board[c] != 0 && _classes[c]._destination == _station )
+            ops.push_back( search_op_t { search_op_t::DISEMBARK, static_cast<uint32_t>(c), _station, 1 } );
+
+    if ( _on_board_total < _capacity ) {
+        for ( size_t c=0; c<_classes.size(); ++c )
+            if ( _waiting[c] != 0 && _classes[c]._origin == _station )
+                ops.push_back( search_op_t { search_op_t::EMBARK, static_cast<uint32_t>(c), _station, 1 } );
+    }
+}
+
+void SearchState::apply( search_op_t const& op )
+{
+    switch ( op._kind ) {
+        case search_op_t::TRANSIT:
+            move_to( op._to );
+            break;
+        case search_op_t::EMBARK:
+            add_waiting( op._from, -1 );
+            add_on_board( op._from, 1 );
+            break;
+        default:
+            add_on_board( op._from, -1 );
+            break;
+    }
+}
+
+void SearchState::undo( search_op_t const& op )
+{
+    switch ( op._kind ) {
+        case search_op_t::TRANSIT:
+            move_to( op._from );
+            break;
+        case search_op_t::EMBARK:
+            add_on_board( op._from, -1 );
+            add_waiting( op._from, 1 );
+            break;
+        default:
+            add_on_board( op._from, 1 );
+            break;
+    }
+}
+
+uint SearchState::heuristic() const
+{
+    uint h = 0;
+    for ( size_t word=0; word<_destinations.size(); ++word ) {
+        uint64_t bits = (_deliver ? _destinations[word] : 0) | (_collect ? _waiting_stations[word] : 0);
+        for ( ; bits != 0; bits &= bits - 1 ) {
+            uint target = static_cast<uint>(word * 64 + __builtin_ctzll(bits));
+            h = std::max( h, _graph->distanceLowerBound(_station, target) );
+        }
+    }
+    return h;
+}
+
+bool SearchState::is_final() const
+{
+    return _station == _origin_station && _on_board_total == 0 && _waiting_total == 0;
+}
+
+void SearchState::add_waiting( size_t c, int delta )
+{
+    uint origin = _classes[c]._origin;
+    _hash ^= _waiting_keys[c * _stride + _waiting[c]];
+    _waiting[c] += delta;
+    _hash ^= _waiting_keys[c * _stride + _waiting[c]];
+
+    _waiting_total += delta;
+    _waiting_at[origin] += delta;
+    set_bit( _waiting_stations, origin, _waiting_at[origin] != 0 );
+}
+
+void SearchState::add_on_board( size_t c, int delta )
+{
+    uint destination = _classes[c]._destination;
+    _hash ^= _on_board_keys[c * _stride + _on_board[c]];
+    _on_board[c] += delta;
+    _hash ^= _on_board_keys[c * _stride + _on_board[c]];
+
+    _on_board_total += delta;
+    _going_to[destination] += delta;
+    set_bit( _destinations, destination, _going_to[destination] != 0 );
+}
+
+void SearchState::move_to( uint station )
+{
+    _hash ^= _station_keys[_station] ^ _station_keys[station];
+    _station = station;
+}
+
+void SearchState::set_bit( vector<uint64_t>& bits, uint station, bool value )
+{
+    uint64_t mask = uint64_t(1) << (station % 64);
+    if ( value )
+        bits[station / 64] |= mask;
+    else
+        bits[station / 64] &= ~mask;
+}
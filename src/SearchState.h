@@ -0,0 +1,114 @@
+#ifndef SEARCHSTATE_H
+#define SEARCHSTATE_H
+
+#include <cstdint>
+#include <vector>
+#include "CompactSearch.h"
+#include "Graph.h"
+#include "State.h"
+#include "Types.h"
+
+using namespace std;
+
+/**
+    An operator of SearchState, with what 'undo' needs to revert it.
+*/
+typedef struct search_op_t
+{
+    static const uint8_t TRANSIT = 0;
+    static const uint8_t EMBARK = 1;
+    static const uint8_t DISEMBARK = 2;
+
+    uint8_t _kind;
+    /* Station the bus leaves for TRANSIT, class moved otherwise. */
+    uint32_t _from;
+    /* Station the bus goes to for TRANSIT. */
+    uint32_t _to;
+    uint _cost;
+} search_op_t;
+
+/**
+    The problem configuration as a single mutable object for
+    depth-first searches: 'apply' and 'undo' change it in place
+    in constant time, without allocating.
+
+    Passengers are counted by class, as in CompactSearch. Along
+    with the counts, it keeps in sync
+
+        - a Zobrist hash of the configuration,
+        - the stations where passengers wait, and
+        - the destinations of the passengers on board,
+
+    the last two as bitsets, so the heuristic of state_t only
+    looks at the stations it takes distances to.
+*/
+class SearchState
+{
+public:
+    SearchState( Graph const* graph, vector<station_t> const& stations, bus_t const& bus,
+        heuristic_t heuristic );
+
+    /**
+        Fill 'ops' with the operators that apply to the current
+        configuration, in the order of state_t::get_successors.
+        'ops' keeps its capacity between calls.
+    */
+    void operators( vector<search_op_t>& ops ) const;
+
+    void apply( search_op_t const& op );
+
+    /* Revert 'op', which must be the last operator applied. */
+    void undo( search_op_t const& op );
+
+    uint heuristic() const;
+
+    bool is_final() const;
+
+    uint64_t hash() const { return _hash; }
+
+    uint station() const { return _station; }
+
+    /* Destination of the passengers of class 'c'. */
+    uint destination( size_t c ) const { return _classes[c]._destination; }
+
+private:
+    Graph const* _graph;
+    vector<compact_class_t> _classes;
+    size_t _station_count;
+    uint _origin_station;
+    uint _capacity;
+    bool _deliver;
+    bool _collect;
+    vector< vector<Transition> > _neighbors;
+
+    /* Configuration */
+    uint _station;
+    uint _on_board_total;
+    vector<uint> _waiting;
+    vector<uint> _on_board;
+
+    /* Passengers waiting at, and on board going to, every station. */
+    vector<uint> _waiting_at;
+    vector<uint> _going_to;
+    vector<uint64_t> _waiting_stations;
+    vector<uint64_t> _destinations;
+    size_t _waiting_total;
+
+    /* Zobrist keys: per station, and per (class, count) with
+       '_stride' counts per class. */
+    uint64_t _hash;
+    uint _stride;
+    vector<uint64_t> _station_keys;
+    vector<uint64_t> _waiting_keys;
+    vector<uint64_t> _on_board_keys;
+
+    /* Change the count of a class and everything kept with it. */
+    void add_waiting( size_t c, int delta );
+    void add_on_board( size_t c, int delta );
+
+    void move_to( uint station );
+
+    static void set_bit( vector<uint64_t>& bits, uint station, bool value );
+};
+
+#endif
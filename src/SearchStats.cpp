@@ -0,0 +1,71 @@
+#include "SearchStats.h"
+#include <sstream>
+
+using namespace std;
+
+string search_stats_t::to_str() const
+{
+    ostringstream stats;
+    
+    string time_to_solve = to_string( _elapsed_seconds );
+    
+    stats << "Overall time: " << time_to_solve << " seconds" << endl;
+    stats << "Overall cost: " << _solution_cost << endl;
+    stats << "# Stops: " << _number_of_stops << endl;
+    stats << "# Expansions: " << _number_of_expansions << endl;
+    return stats.str();
+}
+
+string search_stats_t::to_json( const string& status ) const
+{
+    double heuristic_share = _elapsed_seconds > 0 ? _heuristic_seconds / _elapsed_seconds : 0;
+    double expansion_rate = _elapsed_seconds > 0 ? _number_of_expansions / _elapsed_seconds : 0;
+
+    ostringstream json;
+    json << "{" << endl;
+    json << "  \"status\": \"" << status << "\"," << endl;
+    json << "  \"time_seconds\": " << _elapsed_seconds << "," << endl;
+    json << "  \"cost\": " << _solution_cost << "," << endl;
+    json << "  \"stops\": " << _number_of_stops << "," << endl;
+    json << "  \"expansions\": " << _number_of_expansions << "," << endl;
+    json << "  \"generated\": " << _generated << "," << endl;
+    json << "  \"duplicates_pruned\": " << _duplicates_pruned << "," << endl;
+    json << "  \"reopened\": " << _reopened << "," << endl;
+    json << "  \"stored\": " << _stored << "," << endl;
+    json << "  \"requeued\": " << _requeued << "," << endl;
+    if ( _upper_bound != UINT_MAX )
+        json << "  \"upper_bound\": " << _upper_bound << "," << endl;
+    json << "  \"pruned_by_bound\": " << _pruned_by_bound << "," << endl;
+    json << "  \"peak_open\": " << _peak_open << "," << endl;
+    json << "  \"peak_closed\": " << _peak_closed << "," << endl;
+    json << "  \"bytes_per_open_node\": " << _bytes_per_open_node << "," << endl;
+    json << "  \"bytes_per_closed_node\": " << _bytes_per_closed_node << "," << endl;
+    json << "  \"peak_memory_estimate_bytes\": " << _peak_memory_estimate << "," << endl;
+    json << "  \"heuristic_evaluations\": " << _heuristic_evaluations << "," << endl;
+    json << "  \"heuristic_seconds\": " << _heuristic_seconds << "," << endl;
+    json << "  \"heuristic_time_share\": " << heuristic_share << "," << endl;
+    json << "  \"expansions_per_second\": " << expansion_rate << "," << endl;
+    json << "  \"bytes_read\": " << _bytes_read << "," << endl;
+    json << "  \"bytes_written\": " << _bytes_written << "," << endl;
+    json << "  \"tt_probes\": " << _tt_probes << "," << endl;
+    json << "  \"tt_hits\": " << _tt_hits << "," << endl;
+    json << "  \"tt_hit_rate\": " << (_tt_probes > 0 ? double(_tt_hits) / _tt_probes : 0) << "," << endl;
+    json << "  \"tt_cutoffs\": " << _tt_cutoffs << "," << endl;
+    json << "  \"timeline\": [";
+
+    double previous_time = 0;
+    uint64_t previous_expansions = 0;
+    for ( size_t i=0; i<_timeline.size(); ++i ) {
+        double interval = _timeline[i].first - previous_time;
+        double rate = interval > 0 ? (_timeline[i].second - previous_expansions) / interval : 0;
+        json << (i == 0 ? "" : ",") << endl;
+        json << "    { \"time_seconds\": " << _timeline[i].first
+             << ", \"expansions\": " << _timeline[i].second
+             << ", \"expansions_per_second\": " << rate << " }";
+        previous_time = _timeline[i].first;
+        previous_expansions = _timeline[i].second;
+    }
+    json << endl << "  ]" << endl;
+    json << "}" << endl;
+    return json.str();
+}
@@ -0,0 +1,83 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+    Counters collected while searching. 
+
+    The first four are the ones written to the '.statistics' 
+    file, the rest are only reported in the JSON statistics.
+*/
+typedef struct search_stats_t
+{
+    double _elapsed_seconds         = 0;
+    uint _solution_cost             = 0;
+    uint64_t _number_of_stops       = 0;
+    uint64_t _number_of_expansions  = 0;
+
+    /* Successors created by expansions. */
+    uint64_t _generated             = 0;
+    /* Nodes taken from the open list that were already expanded. */
+    uint64_t _duplicates_pruned     = 0;
+    /* Expanded nodes expanded again with a lower cost. A* over this 
+       domain never does, other search modes may. */
+    uint64_t _reopened              = 0;
+    /* Successors put in the open list. Partial expansion leaves 
+       out the ones over the f of their parent. */
+    uint64_t _stored                = 0;
+    /* Nodes put back in the open list with the f of their next 
+       best successors. */
+    uint64_t _requeued              = 0;
+    /* Cost of a known solution, UINT_MAX if none, and successors
+       never stored because their f is over it. */
+    uint _upper_bound               = UINT_MAX;
+    uint64_t _pruned_by_bound       = 0;
+
+    uint64_t _peak_open             = 0;
+    uint64_t _peak_closed           = 0;
+
+    /* Estimated memory per stored node, see Solver::estimate_memory_use. */
+    size_t _bytes_per_open_node     = 0;
+    size_t _bytes_per_closed_node   = 0;
+    size_t _peak_memory_estimate    = 0;
+
+    uint64_t _heuristic_evaluations = 0;
+    /* Extrapolated from one timed evaluation out of HEURISTIC_SAMPLE_PERIOD. */
+    double _heuristic_seconds       = 0;
+
+    /* Disk traffic of the external memory search. */
+    uint64_t _bytes_read            = 0;
+    uint64_t _bytes_written         = 0;
+
+    /* Transposition table of the depth-first searches: lookups,
+       lookups that found the configuration, and states cut off
+       because it was reached as cheaply before. */
+    uint64_t _tt_probes             = 0;
+    uint64_t _tt_hits               = 0;
+    uint64_t _tt_cutoffs            = 0;
+
+    /* (elapsed seconds, expansions so far) taken along the search. */
+    vector< pair<double, uint64_t> > _timeline;
+
+    static const uint64_t HEURISTIC_SAMPLE_PERIOD = 64;
+
+    /**
+        The four line '.statistics' file format.
+    */
+    string to_str() const;
+
+    /**
+        Every counter as a JSON object. 'status' is the reason 
+        why the search stopped.
+    */
+    string to_json( const string& status ) const;
+
+} search_stats_t;
+
+#endif
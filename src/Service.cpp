@@ -0,0 +1,213 @@
+#include "Service.h"
+#include "Parser.h"
+#include "Solver.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+bool write_all( int fd, const string& data )
+{
+    size_t sent = 0;
+    while ( sent < data.size() ) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if ( n <= 0 )
+            return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/* True once 'request' holds a line reading 'END'. Only looks at
+   the bytes from 'appended' on, which earlier calls have not seen,
+   and the 4 before them a match may start with. */
+bool has_end_line( const string& request, size_t appended )
+{
+    if ( request.size() < 4 )
+        return false;
+    if ( appended < 4 && request.compare(0, 4, "END\n") == 0 )
+        return true;
+    return request.find("\nEND\n", appended < 4 ? 0 : appended - 4) != string::npos;
+}
+
+} // namespace
+
+bool SolverService::run()
+{
+    sockaddr_un address {};
+    if ( _socket_path.size() >= sizeof(address.sun_path) ) {
+        cerr << "Socket path too long: " << _socket_path << endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    _socket_path.copy(address.sun_path, _socket_path.size());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(_socket_path.c_str());
+    if ( listener < 0 ||
+         bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+         listen(listener, SOMAXCONN) != 0 ) {
+        cerr << "Cannot listen on " << _socket_path << endl;
+        if ( listener >= 0 )
+            close(listener);
+        return false;
+    }
+
+    vector<thread> pool;
+    for ( uint i=0; i<_workers; ++i )
+        pool.push_back( thread(&SolverService::worker, this) );
+    cout << "Listening on " << _socket_path << " with " << _workers << " workers." << endl;
+
+    while ( !_stopping ) {
+        // Wake up now and then to notice 'stop'.
+        pollfd waiting { listener, POLLIN, 0 };
+        if ( poll(&waiting, 1, 200) <= 0 )
+            continue;
+        int connection = accept(listener, nullptr, nullptr);
+        if ( connection < 0 )
+            continue;
+
+        lock_guard<mutex> guard { _queue_lock };
+        _connections.push_back( connection );
+        _queue_ready.notify_one();
+    }
+
+    // Not from 'stop' itself: locking is not safe in a signal handler.
+    {
+        lock_guard<mutex> guard { _running_lock };
+        for ( SearchEngine* engine : _running )
+            engine->request_stop();
+    }
+    _queue_ready.notify_all();
+    for ( thread& t : pool )
+        t.join();
+    for ( int connection : _connections )
+        close(connection);
+    close(listener);
+    unlink(_socket_path.c_str());
+    return true;
+}
+
+void SolverService::stop()
+{
+    _stopping = true;
+}
+
+void SolverService::worker()
+{
+    while ( true ) {
+        int connection;
+        {
+            unique_lock<mutex> guard { _queue_lock };
+            // Timed wait, 'stop' may come from a signal handler.
+            _queue_ready.wait_for( guard, chrono::milliseconds(200),
+                [this]() { return _stopping || !_connections.empty(); } );
+            if ( _stopping )
+                return;
+            if ( _connections.empty() )
+                continue;
+            connection = _connections.front();
+            _connections.pop_front();
+        }
+        handle( connection );
+        close( connection );
+    }
+}
+
+void SolverService::handle( int connection )
+{
+    // Do not let a silent client hold a worker forever.
+    timeval timeout { RECEIVE_TIMEOUT_SECONDS, 0 };
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    string request;
+    size_t appended = 0;
+    char buffer[64 * 1024];
+    while ( !has_end_line(request, appended) ) {
+        ssize_t n = recv(connection, buffer, sizeof(buffer), 0);
+        if ( n < 0 ) {
+            write_all( connection, "ERROR incomplete request\n" );
+            return;
+        }
+        if ( n == 0 )
+            break;
+        // Reject unknown commands without waiting for the payload.
+        bool had_command = request.find('\n') != string::npos;
+        appended = request.size();
+        request.append(buffer, static_cast<size_t>(n));
+        if ( !had_command && request.find('\n') != string::npos
+             && request.compare(0, 6, "SOLVE ") != 0 )
+            break;
+        if ( request.size() > MAX_REQUEST_SIZE ) {
+            write_all( connection, "ERROR request too large\n" );
+            return;
+        }
+    }
+    write_all( connection, answer(request) );
+}
+
+string SolverService::answer( const string& request )
+{
+    size_t command_end = request.find('\n');
+    istringstream command { request.substr(0, command_end) };
+    string verb, heuristic;
+    double deadline = _default_deadline;
+    command >> verb >> heuristic;
+    if ( verb != "SOLVE" || heuristic.empty() )
+        return "ERROR expected 'SOLVE <heuristic> [<deadline>]'\n";
+    command >> deadline;
+    heuristic_t parsed = parse_heuristic( heuristic );
+    if ( heuristic_name(parsed) != heuristic )
+        return "ERROR unknown heuristic '" + heuristic + "'\n";
+
+    // The problem runs up to the END line, if any.
+    string_view body;
+    if ( command_end != string::npos ) {
+        body = string_view(request).substr(command_end + 1);
+        size_t end = body.rfind("END\n");
+        if ( end != string_view::npos && (end == 0 || body[end-1] == '\n') )
+            body = body.substr(0, end);
+    }
+
+    problem_t problem;
+    try {
+        problem = parse_problem( body );
+    }
+    catch ( const exception& e ) {
+        return string("ERROR ") + e.what() + "\n";
+    }
+
+    shared_ptr<const Graph> graph = _graphs.acquire( problem.graph );
+    Solver solver( graph.get(), problem.schools, problem.stations, problem.bus,
+        parsed, "" );
+    solver.set_verbose( false );
+    if ( deadline > 0 ) {
+        solver.set_deadline( chrono::steady_clock::now() +
+            chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(deadline)) );
+    }
+
+    {
+        lock_guard<mutex> guard { _running_lock };
+        // Started after 'run' stopped the others.
+        if ( _stopping )
+            solver.request_stop();
+        _running.insert( &solver );
+    }
+    bool solved = solver.solve();
+    {
+        lock_guard<mutex> guard { _running_lock };
+        _running.erase( &solver );
+    }
+    if ( !solved )
+        return "ERROR " + status_to_str(solver.get_status()) + "\n";
+    return "OK\n" + solver.get_solution() + "\n" + solver.stats_to_str() + "END\n";
+}
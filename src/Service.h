@@ -0,0 +1,95 @@
+#ifndef SERVICE_H
+#define SERVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include "GraphCache.h"
+#include "SearchEngine.h"
+
+using namespace std;
+
+/**
+    Long running solver listening on a Unix domain socket.
+
+    A request is a command line followed by the problem in the 
+    '.probl' text format, closed by an 'END' line or by shutting 
+    down the writing side of the connection:
+
+        SOLVE <heuristic> [<deadline in seconds>]
+        P1 P2 P3 ...
+        ...
+        B: P1 5
+        END
+
+    The answer is either
+
+        OK
+        <route, as written to the '.output' file>
+        <statistics, as written to the '.statistics' file>
+        END
+
+    or a single 'ERROR <reason>' line. Graphs and their shortest 
+    path tables stay in a GraphCache between requests, up to 
+    'cache_maps' of them.
+*/
+class SolverService
+{
+public:
+    SolverService( string socket_path, uint workers, double default_deadline,
+        size_t cache_maps = DEFAULT_CACHE_MAPS )
+    : _socket_path { socket_path }
+    , _workers { workers == 0 ? 1 : workers }
+    , _default_deadline { default_deadline }
+    , _graphs { cache_maps }
+    , _stopping { false }
+    {}
+
+    /**
+        Listen and answer requests until 'stop' is called.
+        Returns false if the socket could not be opened.
+    */
+    bool run();
+
+    /**
+        Ask 'run' to return. Safe to call from a signal handler.
+        'run' then interrupts the searches in progress, which 
+        answer 'ERROR interrupted'.
+    */
+    void stop();
+
+    /* Largest request accepted, in bytes. */
+    static const size_t MAX_REQUEST_SIZE = 64 * 1024 * 1024;
+
+    /* Time a client may stay silent while sending a request. */
+    static const int RECEIVE_TIMEOUT_SECONDS = 30;
+
+    /* Maps kept cached, each with a distance table of up to 
+       64 MB. */
+    static const size_t DEFAULT_CACHE_MAPS = 16;
+
+private:
+    string _socket_path;
+    uint _workers;
+    double _default_deadline;   /* Seconds, zero means no deadline. */
+    GraphCache _graphs;
+    atomic<bool> _stopping;
+
+    /* Accepted connections waiting for a worker. */
+    mutex _queue_lock;
+    condition_variable _queue_ready;
+    deque<int> _connections;
+
+    /* Searches in progress, stopped by 'run' once stopping. */
+    mutex _running_lock;
+    set<SearchEngine*> _running;
+
+    void worker();
+    void handle( int connection );
+    string answer( const string& request );
+};
+
+#endif
@@ -3,25 +3,83 @@
 #include <fstream>
 #include "assert.h"
 #include <sstream>
-#include <strings.h>
 #include <algorithm>
+#include "Profiler.h"
+#include "Checkpoint.h"
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace std;
 
-bool Solver::solve() 
+bool Solver::solve()
+{
+    switch (_heuristic) {
+        case heuristic_t::MAX_DISTANCE_PASSENGER:
+            return solve_with<max_distance_passenger_t>();
+        case heuristic_t::MAX_DISTANCE_STATION:
+            return solve_with<max_distance_station_t>();
+        case heuristic_t::ALL:
+            return solve_with<all_heuristics_t>();
+        default:
+            return solve_with<no_heuristic_t>();
+    }
+}
+
+template<class Policy>
+bool Solver::solve_with() 
 {   
     auto start = std::chrono::system_clock::now();
+    auto timeline_start = std::chrono::steady_clock::now();
+    double last_sample = _resumed_seconds;
+    _last_checkpoint = _resumed_seconds;
+    uint timeline_countdown = 0;
 
+    PROFILE_RESET();
     _solved = false;
-    cout << "Search started";
+    _status = search_status_t::EXHAUSTED;
+    if (_verbose) {
+        if (_upper_bound != UINT_MAX)
+            cout << "Greedy route cost: " << _upper_bound << endl;
+        cout << "Search started";
+    }
     while( !_open_states.empty() && !_solved ) {
         //_open_states.sort(less<state_t>());
         /* Expand lowest cost open state. */
-        state_t const* candidate = _open_states.begin()->second;
-        if (_number_of_expanssions % 100000 == 0) {
-            cout << "." << flush;
+        open_entry_t top = _open_states.top();
+        uint candidate_cost = top._g;
+        state_t const* candidate = _open_states.node(top._node)._state;
+        uint32_t parent_record = _open_states.node(top._node)._parent_record;
+        if (_stats._number_of_expansions % 100000 == 0) {
+            if (_verbose)
+                cout << "." << flush;
             //cout << candidate->to_str() << endl << flush;
         }
+        if (_memory_limit != 0 && estimate_memory_use() > _memory_limit) {
+            _status = search_status_t::MEMORY_LIMIT;
+            break;
+        }
+        if (deadline_passed()) {
+            _status = search_status_t::DEADLINE;
+            break;
+        }
+        if (_stop_requested) {
+            _status = search_status_t::INTERRUPTED;
+            break;
+        }
+        if ((++timeline_countdown % TIMELINE_CHECK_PERIOD) == 0) {
+            std::chrono::duration<double> since_start = std::chrono::steady_clock::now() - timeline_start;
+            double now = _resumed_seconds + since_start.count();
+            if (now - last_sample >= TIMELINE_INTERVAL_SECONDS) {
+                last_sample = now;
+                _stats._timeline.push_back(make_pair(last_sample, _stats._number_of_expansions));
+                _stats._peak_memory_estimate = std::max(_stats._peak_memory_estimate, estimate_memory_use());
+            }
+            if (_checkpoint_interval > 0 && now - _last_checkpoint >= _checkpoint_interval) {
+                _last_checkpoint = now;
+                checkpoint_in_background(now);
+            }
+        }
         /* 
             Verify if it is a solution.
             If it is, then recover complete solution.
@@ -33,181 +91,371 @@ bool Solver::solve()
             Unless it has already been expanded.
          */
         if (candidate->is_final()) {
-            cout << "success!" << endl << flush;
+            if (_verbose)
+                cout << "success!" << endl << flush;
             _solved = true;
+            _status = search_status_t::SOLVED;
             _final_node_expansion = candidate->get_expansion();
-            _solution_cost = candidate->get_transition_cost();
+            _final_node_parent = parent_record;
+            _stats._solution_cost = candidate_cost;
         }
         else {
             // If not already expanded, then expand it.
-            if (!_closed_states.lookup( candidate->get_expansion() ) ) {
-                ++_number_of_expanssions;
+            bool already_expanded;
+            {
+                PROFILE_SCOPE(PHASE_CLOSED_LIST);
+                already_expanded = _closed_states.lookup( candidate->get_id() );
+            }
+            if (!already_expanded) {
+                ++_stats._number_of_expansions;
 
                 vector<state_t> succ = candidate->get_successors();
+                _stats._generated += succ.size();
                 
                 //sort( succ.begin(), succ.end(), less<state_t>() );
             
-                _closed_states.insert( candidate->get_expansion() );
+                uint32_t record;
+                {
+                    PROFILE_SCOPE(PHASE_CLOSED_LIST);
+                    _closed_states.insert( candidate->get_id() );
+                    record = _paths.append( parent_record, candidate->get_expansion() );
 
-                for (state_t new_state: succ)
-                    _open_states.insert(pair<uint,state_t const*>(new_state.get_total_cost(), new state_t(new_state)));
+                    // Successors already expanded would be dropped once 
+                    // popped: probe them all at once and drop them now.
+                    _successor_ids.resize(succ.size());
+                    _successor_closed.resize(succ.size());
+                    for (size_t i = 0; i < succ.size(); ++i)
+                        _successor_ids[i] = succ[i].get_id();
+                    _closed_states.lookup_batch(_successor_ids.data(), succ.size(), _successor_closed.data());
+                }
+
+                for (size_t i = 0; i < succ.size(); ++i) {
+                    if (_successor_closed[i]) {
+                        ++_stats._duplicates_pruned;
+                        continue;
+                    }
+                    state_t const& new_state = succ[i];
+                    uint total_cost = new_state.get_transition_cost() + evaluate_heuristic<Policy>(new_state);
+                    // It cannot lead to a solution cheaper than the greedy one.
+                    if (total_cost > _upper_bound) {
+                        ++_stats._pruned_by_bound;
+                        continue;
+                    }
+                    ++_stats._stored;
+                    PROFILE_SCOPE(PHASE_OPEN_LIST);
+                    _open_states.push(total_cost, new_state.get_transition_cost(), new state_t(new_state), record);
+                }
+
+                _stats._peak_open = std::max<uint64_t>(_stats._peak_open, _open_states.size());
+                _stats._peak_closed = _closed_states.size();
             }
+            else
+                ++_stats._duplicates_pruned;
             // Release memory and erase from the queue.
-            delete candidate;
-            _open_states.erase(_open_states.begin());
+            PROFILE_SCOPE(PHASE_OPEN_LIST);
+            _open_states.pop();
         }
     }
     auto end = std::chrono::system_clock::now();
-    _elapsed_seconds = end - start;
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    _stats._elapsed_seconds = _resumed_seconds + elapsed_seconds.count();
+    _stats._timeline.push_back(make_pair(_stats._elapsed_seconds, _stats._number_of_expansions));
+    _stats._peak_memory_estimate = std::max(_stats._peak_memory_estimate, estimate_memory_use());
+    if (_sampled_heuristic_evaluations != 0)
+        _stats._heuristic_seconds = _sampled_heuristic_time.count() 
+            * _stats._heuristic_evaluations / _sampled_heuristic_evaluations;
 
-    if (_solved) 
+    if (_verbose) {
+        PROFILE_REPORT(cout);
+    }
+
+    wait_for_checkpoint();
+    if (_solved) {
         _solution = recover_solution();
-    else 
-        cout << endl << "No solution could be found." << endl;
+        if (!_checkpoint_path.empty())
+            remove(_checkpoint_path.c_str());
+    }
+    else {
+        if (!_checkpoint_path.empty() && _status != search_status_t::EXHAUSTED)
+            save_checkpoint(_checkpoint_path, _stats._elapsed_seconds);
+
+        if (_verbose) {
+            if (_status == search_status_t::MEMORY_LIMIT)
+                cout << endl << "Memory limit reached." << endl;
+            else if (_status == search_status_t::DEADLINE)
+                cout << endl << "Deadline reached." << endl;
+            else if (_status == search_status_t::INTERRUPTED)
+                cout << endl << "Interrupted." << endl;
+            else
+                cout << endl << "No solution could be found." << endl;
+            if (!_checkpoint_path.empty() && _status != search_status_t::EXHAUSTED)
+                cout << "Search saved to " << _checkpoint_path << endl;
+        }
+    }
 
     return _solved;
 }
 
 
-/**
-The solution should contain the path to follow by the bus to take all students to their
-schools and returning to the initial bus stop. 
+string Solver::recover_solution() 
+{
+    vector<expanded_t> ordered_recovery;
+    ordered_recovery.push_back(_final_node_expansion);
+    
+    if (_verbose)
+        cout << "Recovering solution." << endl;
+    // The path store holds the rest, back to the initial node.
+    vector<expanded_t> path = _paths.path_to(_final_node_parent);
+    ordered_recovery.insert(ordered_recovery.end(), path.begin(), path.end());
+    if (_reduction)
+        ordered_recovery = _reduction->expand(ordered_recovery);
 
-It should show up first, the input problem and immediately after the route to follow. 
+    return format_route( ordered_recovery );
+}
 
-For instance P1 → P2 (S: 1 C2, 1 C3) → P3 (B: 1 C2) → · · · → P1 means that the school bus
-starts its journey from bus stop P1. It goes first to bus stop P2 where one student going to
-school C2 , and another going to school C3 get into the bus (and this is denoted by using the 
-prefix S).
+template<class Policy>
+uint Solver::evaluate_heuristic( state_t const& state )
+{
+    PROFILE_SCOPE(PHASE_HEURISTIC);
+    if ((_stats._heuristic_evaluations++ % search_stats_t::HEURISTIC_SAMPLE_PERIOD) != 0)
+        return Policy::evaluate(state);
 
-Next, it goes to bus stop P3 where one student going to school C2 gets off the bus —denoted with the
-letter B. At the end, the bus returns to its initial location.
+    auto start = std::chrono::steady_clock::now();
+    uint cost = Policy::evaluate(state);
+    _sampled_heuristic_time += std::chrono::steady_clock::now() - start;
+    ++_sampled_heuristic_evaluations;
+    return cost;
+}
 
-*/
-string Solver::recover_solution() 
+size_t Solver::estimate_memory_use() const
 {
-    string solution = "";
+    return _open_states.size() * _bytes_per_open_state
+        + _closed_states.size() * (sizeof(uint32_t) + CLOSED_NODE_OVERHEAD)
+        + _paths.size() * sizeof(path_record_t);
+}
 
-    expanded_t expansion = _final_node_expansion;
-    vector<expanded_t> ordered_recovery;
-    ordered_recovery.push_back(_final_node_expansion);
-    
-    cout << "Recovering solution." << endl;
-    while (expansion != _initial_node_expansion) 
-    {
-        // Get the father and put it on the vector.
-        expansion = _closed_states.recover( expansion._parent_id );
-        ordered_recovery.push_back(expansion);
+void Solver::set_checkpoint( const string& path, double interval_seconds )
+{
+    _checkpoint_path = path;
+    _checkpoint_interval = interval_seconds;
+}
+
+void Solver::set_upper_bound( uint cost )
+{
+    _upper_bound = cost;
+    _stats._upper_bound = cost;
+}
+
+void Solver::set_reduction( shared_ptr<GraphReduction const> reduction )
+{
+    _reduction = reduction;
+    _schools = reduction->original_schools();
+}
+
+void Solver::checkpoint_in_background( double elapsed_seconds )
+{
+    if (_checkpoint_writer > 0) {
+        int status = 0;
+        if (waitpid(_checkpoint_writer, &status, WNOHANG) == 0)
+            return;
+        _checkpoint_writer = 0;
+        if (_verbose && (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+            cerr << "Could not write checkpoint " << _checkpoint_path << endl;
     }
-    //ordered_recovery.push_back(expansion);
-
-    // Now parse the recovered path into a string.
-    // We will do this via a finite state machine to identify the type of state.
-    bool previous_parentesis = false;
-    bool first = true;
-    for ( long i = static_cast<long>(ordered_recovery.size())-1; i >= 0 ; --i ) {
-        /* First we need to determine what type of operation was done. */
-        if ( !ordered_recovery[i]._embarking && !ordered_recovery[i]._disembarking ) {
-            // Then we have a transition to another station.
-            ++_number_of_stops;
-            if (previous_parentesis) {
-                solution += ") ";
-                previous_parentesis = false;
-            }
-            if (first) {
-                solution += "P" + to_string( ordered_recovery[i]._station_id ) + " ";
-                first = false;
-            }
-            else
-                solution += "->P" + to_string( ordered_recovery[i]._station_id ) + " ";
-        }
-        else if ( ordered_recovery[i]._embarking && !ordered_recovery[i]._disembarking ) {
-            // Then we have an embarkation of a passenger into the bus. 
-            int school_id = parse_school(ordered_recovery[i]._school_destination);
-            ostringstream sid;
-            sid << school_id;
-            string sch_id = sid.str();
-            if (previous_parentesis)
-                solution += ", 1 C" + sch_id; 
-            else {
-                if (first) 
-                    solution += "->P" + to_string( ordered_recovery[i]._station_id ) + " ";
-                
-                solution += "(S: 1 C" + sch_id;
-                previous_parentesis = true;
-            }
-        }
-        else if ( !ordered_recovery[i]._embarking && ordered_recovery[i]._disembarking ) {
-            // Then we have a disembarking of a passenger into the station.
-            int school_id = parse_school(ordered_recovery[i]._station_id);
-            ostringstream sid;
-            sid << school_id;
-            string sch_id = sid.str();
-            if (previous_parentesis)
-                solution += ", 1 C" + sch_id;
-            else {
-                if (first) 
-                    solution += "->P" + to_string( ordered_recovery[i]._station_id ) + " ";
-                solution += "(B: 1 C" + sch_id;
-                previous_parentesis = true;
-            }
+
+    pid_t child = fork();
+    if (child == 0) {
+        // The child owns a copy on write image of the search.
+        int code = 0;
+        try {
+            save_checkpoint(_checkpoint_path, elapsed_seconds);
         }
-        else {
-            assert (1!=1 && "ERROR: Unreachable state");
+        catch (...) {
+            code = 1;
         }
+        _exit(code);
+    }
+    if (child > 0)
+        _checkpoint_writer = child;
+    else
+        save_checkpoint(_checkpoint_path, elapsed_seconds);
+}
+
+void Solver::wait_for_checkpoint()
+{
+    if (_checkpoint_writer > 0) {
+        waitpid(_checkpoint_writer, nullptr, 0);
+        _checkpoint_writer = 0;
     }
+}
+
+namespace {
+
+const char CHECKPOINT_MAGIC[8] = { 'B', 'R', 'C', 'K', 'P', 'T', '0', '4' };
+
+const uint8_t EMBARKING = 1;
+const uint8_t DISEMBARKING = 2;
 
-    // Done 
-    return solution;
+void save_expansion( SnapshotWriter& out, expanded_t const& expansion )
+{
+    out.u32(expansion._id);
+    out.u32(expansion._parent_id);
+    out.u32(expansion._station_id);
+    out.u8((expansion._embarking ? EMBARKING : 0) | (expansion._disembarking ? DISEMBARKING : 0));
+    out.u32(expansion._school_destination);
+}
+
+expanded_t load_expansion( SnapshotReader& in )
+{
+    uint32_t id = in.u32();
+    uint32_t parent_id = in.u32();
+    uint station = in.u32();
+    uint8_t flags = in.u8();
+    uint school = in.u32();
+    return expanded_t(id, parent_id, station, flags & EMBARKING, flags & DISEMBARKING, school);
 }
 
-int Solver::parse_school( uint station_id) 
+void save_passengers( SnapshotWriter& out, vector<passenger_t> const& passengers )
 {
-    for (school_t school: _schools) {
-        if ( school._station_id == station_id )
-            return static_cast<int>(school._id);
+    out.u32(static_cast<uint32_t>(passengers.size()));
+    for (passenger_t const& passenger : passengers) {
+        out.u32(passenger._origin_id);
+        out.u32(passenger._destination_id);
     }
-    return -1;
 }
 
+void load_passengers( SnapshotReader& in, vector<passenger_t>& passengers )
+{
+    uint32_t count = in.u32();
+    for (uint32_t i=0; i<count; ++i) {
+        uint origin = in.u32();
+        passengers.push_back(passenger_t(origin, in.u32()));
+    }
+}
+
+} // namespace
 
 /**
-    Statistics file. 
-    This file should contain various data about the search process such as 
-    the overall running time, overall cost, step length, number of expansions, etc. 
-    An example is shown below:
-    
-        Overall time: 145
-        Overall cost: 54
-        # Stops: 27
-        # Expansions: 132
-    
-    The name of this file should be suffixed with .statistics.
-        Example: problem.prob.statistics
+    Checkpoint file: 
+
+        magic, initial state ID, heuristic
+        statistics
+        closed nodes: count, then their IDs
+        path store: count, then its records
+        open states: count, then f, the state and its parent 
+            record, in list order
 
+    Open states are written in the order of the open list so 
+    that states with the same f are taken in the same order 
+    after resuming.
 */
-void Solver::write_stats_file() 
+void Solver::save_checkpoint( const string& path, double elapsed_seconds ) const
 {
-    ofstream stats_file;
-    stats_file.open(_filename+".statistics");
-    
-    //ostringstream sid;
-    //sid << _elapsed_seconds;
-    string time_to_solve = to_string( _elapsed_seconds.count() );
-    
-    stats_file << "Overall time: " << time_to_solve << " seconds" << endl;
-    stats_file << "Overall cost: " << _solution_cost << endl;
-    stats_file << "# Stops: " << _number_of_stops << endl;
-    stats_file << "# Expansions: " << _number_of_expanssions << endl;
-    stats_file.close();
+    SnapshotWriter out { path };
+    out.bytes(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.u32(_initial_node_expansion._id);
+    out.str(heuristic_name(_heuristic));
+
+    out.f64(elapsed_seconds);
+    out.u64(_stats._number_of_expansions);
+    out.u64(_stats._generated);
+    out.u64(_stats._stored);
+    out.u64(_stats._duplicates_pruned);
+    out.u64(_stats._reopened);
+    out.u64(_stats._peak_open);
+    out.u64(_stats._peak_closed);
+    out.u64(_stats._peak_memory_estimate);
+    out.u64(_stats._heuristic_evaluations);
+    out.u64(_stats._pruned_by_bound);
+
+    out.u64(_closed_states.size());
+    _closed_states.visit([&out](uint32_t id) {
+        out.u32(id);
+    });
+
+    vector<path_record_t> const& records = _paths.records();
+    out.u64(records.size());
+    out.bytes(records.data(), records.size() * sizeof(path_record_t));
+
+    out.u64(_open_states.size());
+    _open_states.visit([&out](open_entry_t const& entry, open_node_t const& node) {
+        state_t const& state = *node._state;
+        out.u32(entry._f);
+        out.u32(node._parent_record);
+        out.u32(entry._g);
+        save_expansion(out, state.get_expansion());
+
+        bus_t bus = state.get_bus();
+        out.u32(bus._current_station);
+        save_passengers(out, bus._passengers);
+
+        vector<station_t> stations = state.get_vector_stations();
+        out.u32(static_cast<uint32_t>(stations.size()));
+        for (station_t const& station : stations)
+            save_passengers(out, station._passengers);
+    });
+    out.commit();
 }
 
-void Solver::write_down_solution_file()
+void Solver::resume( const string& path )
 {
-    if (_solved) {
-        ofstream solution_file;
-        solution_file.open(_filename+".output");
-        solution_file << _solution << endl;
-        solution_file.close();
+    SnapshotReader in { path };
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    in.bytes(magic, sizeof(magic));
+    if (!equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC))
+        throw runtime_error(path + " is not a checkpoint");
+    if (in.u32() != _initial_node_expansion._id || in.str() != heuristic_name(_heuristic))
+        throw runtime_error(path + " belongs to another problem or heuristic");
+
+    // The initial state provides everything a state shares with the others.
+    state_t const* initial = _open_states.node(_open_states.top()._node)._state;
+    Graph const* graph = initial->get_graph();
+    bus_t bus_template = initial->get_bus();
+
+    _resumed_seconds = in.f64();
+    _stats._number_of_expansions = in.u64();
+    _stats._generated = in.u64();
+    _stats._stored = in.u64();
+    _stats._duplicates_pruned = in.u64();
+    _stats._reopened = in.u64();
+    _stats._peak_open = in.u64();
+    _stats._peak_closed = in.u64();
+    _stats._peak_memory_estimate = in.u64();
+    _stats._heuristic_evaluations = in.u64();
+    _stats._pruned_by_bound = in.u64();
+
+    uint64_t closed = in.u64();
+    for (uint64_t i=0; i<closed; ++i)
+        _closed_states.insert(in.u32());
+
+    vector<path_record_t> records(in.u64());
+    in.bytes(records.data(), records.size() * sizeof(path_record_t));
+    _paths.restore(records);
+
+    // Deletes the states read so far if the file is cut short.
+    OpenList open_states;
+    uint64_t open = in.u64();
+    for (uint64_t i=0; i<open; ++i) {
+        uint f = in.u32();
+        uint32_t parent_record = in.u32();
+        uint cost = in.u32();
+        expanded_t expansion = load_expansion(in);
+
+        bus_t bus = bus_template;
+        bus._passengers.clear();
+        bus._current_station = in.u32();
+        load_passengers(in, bus._passengers);
+
+        vector<station_t> stations;
+        uint32_t station_count = in.u32();
+        for (uint32_t id=1; id<=station_count; ++id) {
+            stations.push_back(station_t(id));
+            load_passengers(in, stations.back()._passengers);
+        }
+        open_states.push(f, cost, new state_t(graph, stations, bus, _heuristic, cost, expansion),
+            parent_record);
     }
+
+    // The states replaced go with 'open_states'.
+    _open_states.swap(open_states);
 }
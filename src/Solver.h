@@ -4,41 +4,91 @@
 //#include <queue>
 //#include <list>
 #include <map>
+#include <memory>
 
 #include <utility>
 #include <ctime>
 #include <chrono>
 #include <functional>
+#include <sys/types.h>
 #include "Types.h"
 #include "State.h"
+#include "SearchEngine.h"
+#include "PathStore.h"
+#include "Heuristics.h"
+#include "GreedyRoute.h"
+#include "GraphReduction.h"
+#include "OpenList.h"
 
 /**
     This class implements a search space solver for the bus 
     transportation problem using A* as search algorithm. 
 */
-class Solver 
+class Solver : public SearchEngine
 {
 private:
-    OrderedSet _closed_states;
-    bool _solved;
+    ClosedSet _closed_states;
     // priority_queue<state_t, vector<state_t>, greater<state_t> > _open_states;
     // list<state_t> _open_states;
-    multimap<uint, state_t const*> _open_states;
+    OpenList _open_states;
+    PathStore _paths;
 
-    vector<school_t> _schools;
-    string _solution;
     expanded_t _final_node_expansion;
+    uint32_t _final_node_parent         = PathStore::NO_PARENT;
     expanded_t _initial_node_expansion;
-    string _filename;
+    heuristic_t _heuristic;
+    /* Successors with a higher f are never stored. */
+    uint _upper_bound;
+    /* Problem being solved if it is a reduced one, see set_reduction. */
+    shared_ptr<GraphReduction const> _reduction;
     string recover_solution();
-    
-    int parse_school( uint station_id );
 
-    /* Statistics */
-    std::chrono::duration<double> _elapsed_seconds;
-    uint64_t _number_of_expanssions = 0; 
-    uint64_t _number_of_stops       = 0;
-    uint _solution_cost             = 0;
+    /**
+        Rough number of bytes held by the open and closed lists, 
+        assuming every open state is the size of the initial one.
+    */
+    size_t estimate_memory_use() const;
+    size_t _bytes_per_open_state    = 0;
+
+    /* Checkpoints */
+    string _checkpoint_path;
+    double _checkpoint_interval     = 0;
+    double _last_checkpoint         = 0;
+    pid_t _checkpoint_writer        = 0;
+    /* Search time spent before the checkpoint this search resumed from. */
+    double _resumed_seconds         = 0;
+
+    /**
+        Snapshot the open and closed lists and the statistics 
+        from a forked child, so the search only stalls for the 
+        fork. Skipped while the previous snapshot is being written.
+    */
+    void checkpoint_in_background( double elapsed_seconds );
+
+    /* Wait for the snapshot being written, if any. */
+    void wait_for_checkpoint();
+
+    void save_checkpoint( const string& path, double elapsed_seconds ) const;
+
+    /**
+        A* with the heuristic of 'Policy', see Heuristics.h.
+    */
+    template<class Policy>
+    bool solve_with();
+
+    /**
+        Heuristic cost of 'state', timing one evaluation out of 
+        HEURISTIC_SAMPLE_PERIOD.
+    */
+    template<class Policy>
+    uint evaluate_heuristic( state_t const& state );
+    std::chrono::duration<double> _sampled_heuristic_time { 0 };
+    uint64_t _sampled_heuristic_evaluations = 0;
+
+    /* IDs of the successors of an expansion, and whether each is
+       closed, reused between expansions. */
+    vector<uint32_t> _successor_ids;
+    vector<uint8_t> _successor_closed;
 
 public: 
     /**
@@ -62,22 +112,30 @@ public:
     */
     Solver( Graph const * graph, vector<school_t> schools, 
         vector<station_t>& stations, bus_t& bus, 
-        string heuristic, string filename)  
-    : _closed_states { }
-    , _solved { false }
-    , _schools { schools }
-    , _filename { filename }
+        heuristic_t heuristic, string filename)  
+    : SearchEngine { schools, filename }
+    , _closed_states { }
+    , _paths { stations.size(), schools }
+    , _heuristic { heuristic }
+    , _upper_bound { greedy_route_cost( graph, stations, bus ) }
     {
         // Initiate the initial state of the problem and insert it into the open_states list.
         state_t initial (graph, stations, bus, heuristic );
        // _open_states = priority_queue<state_t, vector<state_t>, greater<state_t> >();
        // _open_states = list<state_t>();
-       _open_states = multimap<uint, state_t const*>();
         //_open_states.push(initial);
         state_t const* init = new state_t(initial);
-        _open_states.insert(pair<uint, state_t const*>(0 , init));
+        _open_states.push(0, 0, init, PathStore::NO_PARENT);
         _initial_node_expansion = initial.get_expansion();
 
+        size_t passengers = bus._passengers.size();
+        for (station_t const& station : stations)
+            passengers += station._passengers.size();
+        _bytes_per_open_state = sizeof(state_t) + stations.size() * sizeof(station_t)
+            + passengers * sizeof(passenger_t) + OPEN_NODE_OVERHEAD;
+        _stats._bytes_per_open_node = _bytes_per_open_state;
+        _stats._bytes_per_closed_node = sizeof(uint32_t) + CLOSED_NODE_OVERHEAD + sizeof(path_record_t);
+        _stats._upper_bound = _upper_bound;
     } 
 
     /**
@@ -89,28 +147,57 @@ public:
         If a solution is found, return true, otherwise,
         return false.
     */
-    bool solve();
+    bool solve() override;
+
+    /**
+        Snapshot the search into 'path' every 'interval_seconds', 
+        and once more if it stops without a solution. The file 
+        is removed once a solution is found.
+
+        Snapshots are written by a forked child process, so 
+        only enable them in single threaded programs.
+    */
+    void set_checkpoint( const string& path, double interval_seconds );
+
+    /**
+        Discard successors with an f over 'cost' instead of storing
+        them. The constructor sets it to the cost of the route of
+        'greedy_route_cost'; UINT_MAX keeps every successor. With an
+        admissible heuristic, no optimal solution is discarded.
+    */
+    void set_upper_bound( uint cost );
 
     /**
-        Write down in a file statistics of the search task.
-            - Overall running time. 
-            - Number of expansions. 
-            - Overall cost of the solution.
-            - Solution length.
+        Tell the solver it was built with the problem of 'reduction', 
+        so the route it writes is expanded back to the original map. 
+        The reduction is kept alive as long as the solver.
     */
-    void write_stats_file();
+    void set_reduction( shared_ptr<GraphReduction const> reduction );
 
     /**
-        Write down the solution if available.
+        Replace the initial state with the search saved in the 
+        checkpoint at 'path'. Solving then continues exactly 
+        where the snapshot was taken and finds the same solution 
+        with the same statistics. Throws runtime_error if the 
+        file is unreadable or belongs to another problem.
     */
-    void write_down_solution_file();
+    void resume( const string& path );
+
+    /* Allocator and container bookkeeping per stored node. An
+       open node is a heap entry, a slot of the state store and the
+       allocator header of its state. The closed set, a hash table
+       at most half full, keeps one to three spare slots per ID. */
+    static const size_t OPEN_NODE_OVERHEAD = sizeof(open_entry_t) + sizeof(open_node_t) + 16;
+    static const size_t CLOSED_NODE_OVERHEAD = 2 * sizeof(uint32_t);
+
+    /* Iterations between clock reads for the expansion timeline, 
+       and the minimum time between two timeline samples. */
+    static const uint TIMELINE_CHECK_PERIOD = 1024;
+    static constexpr double TIMELINE_INTERVAL_SECONDS = 0.25;
 
     ~Solver() 
     {
-        for (auto pos = _open_states.begin(); pos != _open_states.end(); ++pos) 
-        {
-            delete pos->second;
-        }
+        wait_for_checkpoint();
     }
 };
 
@@ -5,11 +5,38 @@
 #include "assert.h"
 #include <stdio.h>
 #include <string.h>
+#include "Profiler.h"
+#include <algorithm>
 
 
+heuristic_t parse_heuristic( const string& name )
+{
+    if (MAX_DIST_PASSENGER_H.compare(name) == 0)
+        return heuristic_t::MAX_DISTANCE_PASSENGER;
+
+    if (MAX_DIST_STATION_H.compare(name) == 0)
+        return heuristic_t::MAX_DISTANCE_STATION;
+
+    if (ALL_H.compare(name) == 0)
+        return heuristic_t::ALL;
+
+    return heuristic_t::NONE;
+}
+
+string heuristic_name( heuristic_t heuristic )
+{
+    switch (heuristic) {
+        case heuristic_t::MAX_DISTANCE_PASSENGER:   return MAX_DIST_PASSENGER_H;
+        case heuristic_t::MAX_DISTANCE_STATION:     return MAX_DIST_STATION_H;
+        case heuristic_t::ALL:                      return ALL_H;
+        default:                                    return "none";
+    }
+}
 
 uint32_t state_t::hash( const bus_t& bus, const vector<station_t>& stations, uint32_t father_id)
 {
+    PROFILE_SCOPE(PHASE_HASH);
+
     // Get the buffer size in bytes. 
     size_t len = sizeof(uint) + 2 * sizeof(uint) * bus._passengers.size() + sizeof(uint32_t);
     for ( station_t stat: stations )
@@ -148,6 +175,7 @@ state_t state_t::embark_passenger( passenger_t passenger ) const
 
 vector<state_t> state_t::get_successors() const 
 {
+    PROFILE_SCOPE(PHASE_SUCCESSORS);
     vector<state_t> successors;
     
     /* Get successors by station trip. */
@@ -171,6 +199,69 @@ vector<state_t> state_t::get_successors() const
     return successors;
 }
 
+uint state_t::get_operator_count() const
+{
+    uint count = _transition_graph->getNeighbors(_bus._current_station).size();
+
+    for ( passenger_t embarked_passenger: _bus._passengers )
+        if (embarked_passenger._destination_id == _bus._current_station)
+            ++count;
+
+    if ( _bus._passengers.size() < _bus._max_passengers )
+        count += _stations[_bus._current_station-1]._passengers.size();
+
+    return count;
+}
+
+state_t state_t::get_successor( uint op ) const
+{
+    PROFILE_SCOPE(PHASE_SUCCESSORS);
+    vector<Transition> neighbors = _transition_graph->getNeighbors(_bus._current_station);
+    if (op < neighbors.size())
+        return transit_to_station( neighbors[op] );
+    op -= neighbors.size();
+
+    for ( passenger_t embarked_passenger: _bus._passengers )
+        if (embarked_passenger._destination_id == _bus._current_station) {
+            if (op == 0)
+                return disembark_passenger( embarked_passenger );
+            --op;
+        }
+
+    assert ( _bus._passengers.size() < _bus._max_passengers );
+    return embark_passenger( _stations[_bus._current_station-1]._passengers[op] );
+}
+
+vector<uint> state_t::get_successor_total_costs() const
+{
+    PROFILE_SCOPE(PHASE_HEURISTIC);
+    bool deliver = _heuristic == heuristic_t::ALL || _heuristic == heuristic_t::MAX_DISTANCE_PASSENGER;
+    bool collect = _heuristic == heuristic_t::ALL || _heuristic == heuristic_t::MAX_DISTANCE_STATION;
+    uint current = _bus._current_station;
+
+    vector<uint> costs;
+    for ( Transition trip: _transition_graph->getNeighbors(current) )
+        costs.push_back(_transition_cost + trip.cost + max_distance_to_targets(trip.destination, deliver, collect));
+
+    // The bus stays: the passenger getting off was at distance 0, 
+    // and so is the station a passenger leaves.
+    uint h = max_distance_to_targets(current, deliver, collect);
+
+    for ( passenger_t embarked_passenger: _bus._passengers )
+        if (embarked_passenger._destination_id == current)
+            costs.push_back(_transition_cost + 1 + h);
+
+    if ( _bus._passengers.size() < _bus._max_passengers ) {
+        for ( passenger_t waiting_passenger: _stations[current-1]._passengers ) {
+            uint embarked_h = h;
+            if (deliver)
+                embarked_h = std::max(h, _transition_graph->distanceLowerBound(current, waiting_passenger._destination_id));
+            costs.push_back(_transition_cost + 1 + embarked_h);
+        }
+    }
+    return costs;
+}
+
 bool state_t::is_final() const 
 {
 
@@ -208,7 +299,7 @@ expanded_t state_t::get_expansion() const { return _expanded_form; }
 
 uint32_t state_t::get_id() const { return _hash; }
 
-string state_t::get_heuristic() const { return _heuristic; }
+heuristic_t state_t::get_heuristic() const { return _heuristic; }
 
 uint state_t::get_transition_cost() const { return _transition_cost; }
 
@@ -236,55 +327,19 @@ uint state_t::min(vector<uint> const &costs) const
     return min;
 }
 
-/* Returns the maximum distance to recover a new passenger. */
-uint state_t::max_cost_to_passenger() const 
-{
-    vector<uint> distances;
-    distances.push_back(0);
-    for (station_t station : _stations) {
-        if (station._passengers.size() != 0) {
-            distances.push_back(
-                _transition_graph->shortestPathCost(
-                    _bus._current_station, station._id
-                )
-            );
-        }
-    }
-    return max(distances);
-}
-
-/* Returns the maximum distance to deliver a passenger to its destination. */
-uint state_t::max_distance_to_deliver_passenger() const
-{
-    vector<uint> distances;
-    
-    for (passenger_t pass : _bus._passengers) {
-        distances.push_back(
-            _transition_graph->shortestPathCost(
-                 _bus._current_station, pass._destination_id)
-        );
-    }
-    if (distances.size() == 0) 
-        return 0;
-    return max(distances);
-}
-
 uint state_t::get_heuristic_cost() const 
 {
-    vector<uint> h_costs;
-    h_costs.push_back(0);
-    if (_heuristic.compare(ALL_H) == 0) {
-        h_costs.push_back(max_distance_to_deliver_passenger());
-        h_costs.push_back(max_cost_to_passenger());
+    PROFILE_SCOPE(PHASE_HEURISTIC);
+    switch (_heuristic) {
+        case heuristic_t::MAX_DISTANCE_PASSENGER:
+            return max_distance_to_deliver_passenger();
+        case heuristic_t::MAX_DISTANCE_STATION:
+            return max_cost_to_passenger();
+        case heuristic_t::ALL:
+            return std::max(max_distance_to_deliver_passenger(), max_cost_to_passenger());
+        default:
+            return 0;
     }
-
-    if (_heuristic.compare(MAX_DIST_PASSENGER_H) == 0)
-        h_costs.push_back(max_distance_to_deliver_passenger());
-    
-    if (_heuristic.compare(MAX_DIST_STATION_H) == 0) 
-        h_costs.push_back(max_cost_to_passenger());
-
-    return max(h_costs);
 }
 
 string state_t::to_str() const 
@@ -1,11 +1,13 @@
 #ifndef STATE_H
 #define STATE_H
 
-#include "OrderedSet.h"
+#include "ClosedSet.h"
 #include "Graph.h"
 #include "Types.h"
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <cstdint>
 
 static const string MAX_DIST_PASSENGER_H = "max_distance_passenger";
 static const string MAX_DIST_STATION_H = "max_distance_station";
@@ -13,6 +15,27 @@ static const string ALL_H = "all";
 
 using namespace std;
 
+/**
+    Heuristic a state is evaluated with.
+*/
+enum class heuristic_t : uint8_t
+{
+    NONE,
+    MAX_DISTANCE_PASSENGER,
+    MAX_DISTANCE_STATION,
+    ALL
+};
+
+/**
+    The heuristic named 'name', NONE if it does not name one.
+*/
+heuristic_t parse_heuristic( const string& name );
+
+/**
+    Inverse of 'parse_heuristic'.
+*/
+string heuristic_name( heuristic_t heuristic );
+
 class state_t 
 {
 private:
@@ -39,7 +62,7 @@ private:
     /** Heuristic used. 
         Required of the operator overload.
     */
-    string _heuristic;
+    heuristic_t _heuristic;
 
     /**
         The expanded state representation. 
@@ -59,16 +82,12 @@ private:
     
     uint min (vector<uint> const &costs) const;
 
-    uint max_cost_to_passenger() const;
-    
-    uint max_distance_to_deliver_passenger() const;
-
 public:
 
     /**
         Initial state constructor. 
     */
-    state_t(const Graph* graph, vector<station_t>& stations, bus_t& bus, string heuristic)
+    state_t(const Graph* graph, vector<station_t>& stations, bus_t& bus, heuristic_t heuristic)
     : _bus { bus }
     , _transition_cost { 0 } 
     , _transition_graph { graph } // Store a reference.
@@ -87,6 +106,22 @@ public:
         );
     }
     
+    /**
+        Restoration constructor. Rebuild a state from its parts,
+        as stored by searches that keep nodes outside of state_t.
+        The ID is taken from 'expansion'.
+    */
+    state_t(const Graph* graph, vector<station_t>& stations, bus_t& bus, heuristic_t heuristic,
+        uint cost, expanded_t expansion)
+    : _bus { bus }
+    , _transition_cost { cost }
+    , _transition_graph { graph } // Store a reference.
+    , _stations { stations }
+    , _hash { expansion._id }
+    , _heuristic { heuristic }
+    , _expanded_form { expansion }
+    {}
+
     /**
         Copy constructor.
     */
@@ -236,6 +271,40 @@ public:
     */
     vector<state_t> get_successors() const;
 
+    /**
+        Number of successors 'get_successors' returns.
+    */
+    uint get_operator_count() const;
+
+    /**
+        PRECONDITIONS:
+        + op < get_operator_count().
+        DETAILS:
+        + Returns the successor at position 'op' of 'get_successors' 
+        without building the others.
+    */
+    state_t get_successor( uint op ) const;
+
+    /**
+        DETAILS:
+        + Returns 'get_total_cost' of each successor, in the order of 
+        'get_successors', without building them.
+        + Moving the bus changes the distance of every term of the 
+        heuristic, disembarking at the destination changes none and 
+        embarking only adds the distance to the new destination.
+        + Terms come from 'max_distance_to_targets', as in 
+        'get_heuristic_cost', so they match the built successors.
+    */
+    vector<uint> get_successor_total_costs() const;
+
+    /**
+        Largest lower bound on the distance from 'station' to the 
+        destination of a passenger on the bus, with 'deliver', and 
+        to a station with passengers waiting, with 'collect'. Every 
+        term of the heuristics is computed with it.
+    */
+    inline uint max_distance_to_targets( uint station, bool deliver, bool collect ) const;
+
     /** GETTERS **/
     
     uint get_transition_cost() const;
@@ -245,6 +314,20 @@ public:
     */
     uint get_heuristic_cost() const;
 
+    /**
+        Returns the maximum distance to a station with passengers 
+        waiting. Heuristic "max_distance_station". Inline, like 
+        the one below, so the policies of Heuristics.h inline 
+        them into the expansion loop.
+    */
+    inline uint max_cost_to_passenger() const;
+    
+    /**
+        Returns the maximum distance to the destination of a 
+        passenger on the bus. Heuristic "max_distance_passenger".
+    */
+    inline uint max_distance_to_deliver_passenger() const;
+
     /**
         Given the heuristic '_heuristic', get total cost.
     */
@@ -264,7 +347,7 @@ public:
 
     uint32_t            get_id() const;
 
-    string              get_heuristic() const;
+    heuristic_t         get_heuristic() const;
 
     bool                is_final() const; 
 
@@ -309,4 +392,32 @@ public:
 
 };
 
+uint state_t::max_distance_to_targets( uint station, bool deliver, bool collect ) const
+{
+    uint distance = 0;
+    if (deliver) {
+        for (passenger_t const& pass : _bus._passengers)
+            distance = std::max(distance,
+                _transition_graph->distanceLowerBound(station, pass._destination_id));
+    }
+    if (collect) {
+        for (station_t const& waiting : _stations) {
+            if (waiting._passengers.size() != 0)
+                distance = std::max(distance,
+                    _transition_graph->distanceLowerBound(station, waiting._id));
+        }
+    }
+    return distance;
+}
+
+uint state_t::max_cost_to_passenger() const 
+{
+    return max_distance_to_targets(_bus._current_station, false, true);
+}
+
+uint state_t::max_distance_to_deliver_passenger() const
+{
+    return max_distance_to_targets(_bus._current_station, true, false);
+}
+
 #endif
@@ -0,0 +1,54 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+using namespace std;
+
+TranspositionTable::TranspositionTable( size_t bytes, replacement_t replacement )
+: _entries {}
+, _mask { 0 }
+, _replacement { replacement }
+{
+    // A power of two of slots, so the hash is masked instead of divided.
+    size_t slots = 1;
+    while ( slots * 2 * sizeof(tt_entry_t) <= bytes )
+        slots *= 2;
+    if ( slots * sizeof(tt_entry_t) > bytes )
+        return;
+    // Entries of age 0 are empty.
+    _entries.assign( slots, tt_entry_t { 0, 0, 0, 0, 0 } );
+    _mask = slots - 1;
+}
+
+tt_entry_t* TranspositionTable::probe( uint64_t key )
+{
+    ++_probes;
+    tt_entry_t& entry = _entries[key & _mask];
+    if ( entry._age == 0 || entry._key != key )
+        return nullptr;
+    ++_hits;
+    return &entry;
+}
+
+void TranspositionTable::store( uint64_t key, uint g, uint h, uint depth )
+{
+    tt_entry_t& entry = _entries[key & _mask];
+    bool replace = entry._age == 0 || entry._key == key || _replacement == replacement_t::AGE
+        || entry._age != _age || depth <= entry._depth;
+    if ( !replace )
+        return;
+    entry = tt_entry_t { key, g, h, static_cast<uint16_t>(std::min<uint>(depth, UINT16_MAX)), _age };
+}
+
+void TranspositionTable::new_iteration()
+{
+    if ( ++_age != 0 )
+        return;
+    // Ages wrapped around: old entries would pass for new ones.
+    _entries.assign( _entries.size(), tt_entry_t { 0, 0, 0, 0, 0 } );
+    _age = 1;
+}
+
+TranspositionTable::replacement_t TranspositionTable::replacement_from_name( const string& name )
+{
+    return name == "age" ? replacement_t::AGE : replacement_t::DEPTH;
+}
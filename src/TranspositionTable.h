@@ -0,0 +1,81 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+    What the transposition table knows of a configuration.
+*/
+typedef struct tt_entry_t
+{
+    uint64_t _key;
+    /* Cheapest g it was reached with. */
+    uint32_t _g;
+    /* Lower bound on its cost to go: its heuristic, raised to what
+       searching under it showed. */
+    uint32_t _h;
+    /* Operators from the initial state. */
+    uint16_t _depth;
+    /* Iteration it was stored in. */
+    uint16_t _age;
+} tt_entry_t;
+
+/**
+    Fixed size, lossy table of configurations for depth-first
+    searches, one entry per slot, addressed by the low bits of
+    the configuration hash. Full keys are compared, so a probe
+    never returns another configuration, but entries are lost
+    when their slot is taken.
+
+    Slots go to the newest entry with AGE replacement. With DEPTH
+    replacement an entry of the current iteration is only taken
+    by one as shallow or shallower, whose subtree is larger.
+*/
+class TranspositionTable
+{
+public:
+    enum class replacement_t { DEPTH, AGE };
+
+    /* A table of at most 'bytes', zero for no table. */
+    TranspositionTable( size_t bytes = 0, replacement_t replacement = replacement_t::DEPTH );
+
+    bool enabled() const { return !_entries.empty(); }
+
+    /**
+        Find 'key'. Returns nullptr if it is not stored.
+    */
+    tt_entry_t* probe( uint64_t key );
+
+    /**
+        Store, or update, the entry of 'key' if the replacement
+        policy lets it into its slot.
+    */
+    void store( uint64_t key, uint g, uint h, uint depth );
+
+    /* Start a new iteration, aging every stored entry. */
+    void new_iteration();
+
+    uint16_t age() const { return _age; }
+
+    size_t size_in_bytes() const { return _entries.size() * sizeof(tt_entry_t); }
+
+    uint64_t probes() const { return _probes; }
+    uint64_t hits() const { return _hits; }
+
+    static replacement_t replacement_from_name( const string& name );
+
+private:
+    vector<tt_entry_t> _entries;
+    uint64_t _mask;
+    replacement_t _replacement;
+    uint16_t _age             = 1;
+
+    uint64_t _probes          = 0;
+    uint64_t _hits            = 0;
+};
+
+#endif
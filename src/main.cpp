@@ -9,9 +9,21 @@
 #include <functional>
 
 #include "Graph.h"
+#include "Parser.h"
 #include "Types.h"
 #include "assert.h"
 #include "Solver.h"
+#include "ExternalSearch.h"
+#include "FrontierSearch.h"
+#include "LazySearch.h"
+#include "CompactSearch.h"
+#include "DepthFirstSearch.h"
+#include "ParallelDepthFirstSearch.h"
+#include "Batch.h"
+#include "Service.h"
+#include "Options.h"
+#include <csignal>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -20,272 +32,201 @@ using namespace std;
 ******************************************/
 //#define TESTING
 void test_graph();
-void test_string_split();
+void test_parser();
 void test_state_type( state_t& state );
 
 
 /******************************************
-*             FILE PARSING                *
+*             COMMAND LINE                *
 *******************************************/
 
+void print_usage()
+{
+	cout << "Usage: bus-routing <problem.prob> [<heuristic>] [--json-stats] [--search=astar] [--generic] "
+		<< "[--checkpoint=<file>] [--checkpoint-every=<seconds>] [--resume] [--no-upper-bound] [--no-reduce]" << endl;
+	cout << "       bus-routing <problem.prob> [<heuristic>] --search=frontier|lazy|epea [--json-stats]" << endl;
+	cout << "       bus-routing <problem.prob> [<heuristic>] --search=ida "
+		<< "[--tt-mb=<MB>] [--tt-replace=depth|age] [--json-stats]" << endl;
+	cout << "       bus-routing <problem.prob> [<heuristic>] --search=pida [--threads=<n>] [--no-shared-closed] [--json-stats]" << endl;
+	cout << "       bus-routing <problem.prob> [<heuristic>] --search=compact [--json-stats]" << endl;
+	cout << "       bus-routing <problem.prob> [<heuristic>] --search=external "
+		<< "[--work-dir=<dir>] [--sort-memory=<MB>] [--resume]" << endl;
+	cout << "       bus-routing --batch=<manifest> [--workers=<n>] "
+		<< "[--memory-limit=<MB>] [--summary=<file.csv>] [--json-stats]" << endl;
+	cout << "       Maps over " << Graph::MAX_PRECOMPUTED_NODES << " stations: [--landmarks=<k>] or [--hierarchy]" << endl;
+	cout << "       bus-routing --serve=<socket> [--workers=<n>] [--deadline=<seconds>] [--cache-maps=<n>]" << endl;
+}
+
 /**
- Helper function used to split a string into a vector given a 
- 'splt' character. 
- */
-void split_string(string& str, vector<string>& vec, char splt) 
+	Solve every job of a manifest, see BatchRunner.
+*/
+int run_batch(int argc, char* argv[])
 {
-	// Avoid split character at the start of the string.
-	uint i = 0; 
-	while (str[i] == splt) { ++i; }
-	uint j = i+1; 
-	while (j < str.length()) {
-		if (str[j] == splt) {
-			vec.push_back( str.substr(i, j-i) );
-			i = j + 1;
-			++j;
-		} 
-		else if ( str[j] == '\n' ) {
-			vec.push_back( str.substr(i, j-i) );
-			// end of the line. 
-			break;
-		}
-		else if ( j+1 == str.length() ) {
-			vec.push_back( str.substr(i, j-i+1) );
-			// end of the line. 
-			break;
-		}
-		else {
-			++j;
-		}
+	string manifest = get_option(argc, argv, "batch", "");
+	uint workers = stoul(get_option(argc, argv, "workers", 
+		to_string(thread::hardware_concurrency())));
+	size_t memory_limit = static_cast<size_t>(
+		stod(get_option(argc, argv, "memory-limit", "0")) * 1024 * 1024);
+	string summary = get_option(argc, argv, "summary", manifest + ".summary.csv");
+
+	vector<batch_job_t> jobs;
+	try {
+		jobs = BatchRunner::read_manifest(manifest, memory_limit);
 	}
-	for (auto it = vec.begin(); it != vec.end(); ++it) {
-		if (static_cast<string>(*it).compare("") == 0)
-			vec.erase(it);
+	catch ( const exception& e ) {
+		cerr << e.what() << endl;
+		return 1;
 	}
+
+	BatchRunner runner( jobs, workers );
+	runner.set_json_stats( has_option(argc, argv, "json-stats") );
+	runner.run();
+	runner.write_summary( summary );
+	cout << "Summary written to " << summary << endl;
+	return 0;
 }
 
-Graph generate_graph(char* argv[]) 
-{
-	// Input file is the first argument, 
-	ifstream infile(argv[1]);
-	
-	// Read up first line. 
-	string line;
-	getline(infile, line);
-	vector<string> stations_vstr;
-	// "P1 P2" -> ["P1", "P2"]
-	split_string(line, stations_vstr, ' ');
-
-	// Now we have the number of lines to process. 
-	size_t node_count = stations_vstr.size();
-	vector<uint> nodes {};
-
-	/* Obtain edges per node. */ 
-	vector<Edge> graph_edges;
-	for (uint i=1; i<=node_count; ++i) {
-		getline(infile, line);
-		// i is the considered node. 
-		// The i'th line contains the adjacent nodes cost 
-		// of transition values. 
-		vector<string> costs;
-		split_string(line, costs, ' ');
-
-		// Now we need to parse the costs. 
-
-		// If they are defined, then the nodes are adjacent.
-		// Otherwise, there is no edge between them.
-
-		// As this is an undirected graph, then we have to 
-		// only process half of the matrix. 
-		for (uint j=1; j<=node_count; ++j) {
-		//cout << costs[j] << " ";
-			if (costs[j].compare( "--" ) == 0)
-				continue;
-			else 
-				graph_edges.push_back(
-					Edge(i, j, stoi( costs[j], nullptr, 10) )
-					); 
-		}
-		//cout << endl;
-	}
 
-	// We will share this graph pointer among all the 
-	// instances of the state_t classes. 
-	Graph g {graph_edges, node_count};
-	return g;
-} 
+SolverService* running_service = nullptr;
+
+void stop_service(int)
+{
+	if (running_service)
+		running_service->stop();
+}
 
 /**
-	Helper function to extract alphanumerics on a string in order. 
-	Example: ' C2: P3' -> [2, 3]
+	Answer requests on a Unix domain socket until interrupted, 
+	see SolverService.
 */
-void extract_alphanumerics_in_order(string str, vector<uint> &result) 
-{	
-	//vector<uint> result;
-	string digit { "" }; // string to which append several digits.
-	for (uint i=0; i<str.length(); ++i) 
-	{
-		if (isdigit( str[i] )) {
-			digit += str[i];
-		}
-		else {
-			if (!digit.empty()) {
-				result.push_back ( 
-					static_cast<uint>(stoi( digit )) 
-				);
-				digit.clear();
-			}
-		}
-	}
-	result.push_back ( 
-			static_cast<uint>(stoi( digit )) 
-		);
+int run_service(int argc, char* argv[])
+{
+	string socket_path = get_option(argc, argv, "serve", "");
+	uint workers = stoul(get_option(argc, argv, "workers", 
+		to_string(thread::hardware_concurrency())));
+	double deadline = stod(get_option(argc, argv, "deadline", "0"));
+	size_t cache_maps = stoul(get_option(argc, argv, "cache-maps", 
+		to_string(SolverService::DEFAULT_CACHE_MAPS)));
+
+	SolverService service( socket_path, workers, deadline, cache_maps );
+	running_service = &service;
+	signal(SIGINT, stop_service);
+	signal(SIGTERM, stop_service);
+	bool clean = service.run();
+	running_service = nullptr;
+	return clean ? 0 : 1;
 }
 
 
-/** 
-	Get all the schools and the stations where they are located. 
+SearchEngine* running_search = nullptr;
 
-	/!\ This function depends on the fact that all the schools are 
-	listed on the same line on the problem file. 
-*/
-void parse_schools(char*argv[], uint number_of_nodes, vector<school_t> &result)
+void stop_search(int)
 {
-	// Input file is the first argument, 
-	ifstream infile(argv[1]);
-
-	// Read up to the part where the shools are listed. 
-	string line;
-	for (uint i=0; i<= number_of_nodes; ++i) 
-		getline(infile, line);
-
-	// Next line to read is the school list. 
-	getline(infile, line);
-	vector<string> schools;
-	// Split each school on the line by character ';' into a vector.
-	// 'C1: P6; C2: P3' ->  ['C1: P6', ' C2: P3']
-	split_string(line, schools, ';');
-
-	// Now we need to create a school_t object per string ' C2: P3'.
-	for (string school: schools) {
-		// Extract alphanumeric characters.
-		vector<uint> num;
-		extract_alphanumerics_in_order(school, num);
-		// First number is the school ID, the second is the 
-		// station ID
-		result.push_back ( school_t(num[0], num[1]) );
-	}
+	if (running_search)
+		running_search->request_stop();
 }
 
 /**
-	Helper function to find the station ID of a school in the a school 
-	vector.
-
-	If the school is undefined, then return -1;
+	Build the search algorithm picked with '--search'. 
+	Returns nullptr if it is unknown.
 */
-int findSchoolStationOnList( uint school_id, vector<school_t> &schools )
+unique_ptr<SearchEngine> make_search(int argc, char* argv[], problem_t& problem, 
+	heuristic_t heuristic, string filename)
 {
-	for (school_t school: schools) {
-		if (school._id == school_id) return school._station_id;
+	string search = get_option(argc, argv, "search", "astar");
+	// A* takes compact states when the problem fits them, unless asked
+	// for the generic solver or one of the options only it has.
+	bool generic = has_option(argc, argv, "generic") || has_option(argc, argv, "no-reduce")
+		|| has_option(argc, argv, "no-upper-bound") || has_option(argc, argv, "checkpoint")
+		|| has_option(argc, argv, "checkpoint-every") || has_option(argc, argv, "resume");
+	if (search == "compact" || (search == "astar" && !generic)) {
+		unique_ptr<SearchEngine> compact = make_compact_search( &problem.graph, problem.schools, 
+			problem.stations, problem.bus, heuristic, filename );
+		if (compact) {
+			cout << "Searching with compact states" << endl;
+			return compact;
+		}
+		if (search == "compact")
+			cout << "The problem is too large for compact states, using A*." << endl;
+		search = "astar";
+	}
+	if (search == "astar") {
+		// Search over the relevant stations only, see GraphReduction.
+		shared_ptr<GraphReduction> reduction;
+		if (!has_option(argc, argv, "no-reduce")) {
+			reduction = make_shared<GraphReduction>( problem.graph, problem.stations, 
+				problem.bus, problem.schools );
+			cout << "Reduced the map from " << reduction->original_size() << " to " 
+				<< reduction->reduced_size() << " stations" << endl;
+		}
+		Solver* solver = reduction 
+			? new Solver( &reduction->graph(), reduction->schools(), 
+				reduction->stations(), reduction->bus(), heuristic, filename)
+			: new Solver( &problem.graph, problem.schools, 
+				problem.stations, problem.bus, heuristic, filename);
+		unique_ptr<SearchEngine> engine { solver };
+		if (reduction)
+			solver->set_reduction( reduction );
+		if (has_option(argc, argv, "no-upper-bound"))
+			solver->set_upper_bound( UINT_MAX );
+
+		string checkpoint = get_option(argc, argv, "checkpoint", "");
+		if (checkpoint.empty())
+			checkpoint = filename + ".checkpoint";
+		if (has_option(argc, argv, "checkpoint") || has_option(argc, argv, "checkpoint-every"))
+			solver->set_checkpoint( checkpoint, 
+				stod(get_option(argc, argv, "checkpoint-every", "600")) );
+		if (has_option(argc, argv, "resume")) {
+			cout << "Resuming search from " << checkpoint << endl;
+			solver->resume( checkpoint );
+		}
+		return engine;
 	}
-	return -1;
-}
 
-/* 
-	Create a vector of stations, initializing accordingly the passengers
- 	vector on each.
-*/
-void parse_stations(char*argv[], uint number_of_nodes,
-	 	vector<station_t> &result, vector<school_t> &schools)
-{
-	// Input file is the first argument, 
-	ifstream infile(argv[1]);
-
-	// Read up to the part where the stations are listed. 
-	string line;
-	for (uint i=0; i<= number_of_nodes+1; ++i) 
-		getline(infile, line);
-
-	// Next line is the part where the station's passengers are 
-	// listed. 
-	getline(infile, line);
-	vector<string> stations;
-	split_string(line, stations, ';');
-
-	// Now we can define the stations. 
-	// Each station is defined by a stationID and a vector of 
-	// passengers. 
-	// We will store all the stations by their ID. 
-	// Example: 
-	//  result[0] -> station 1, result[3] -> station 2 and so on.
-	
-	// Initialize all the stations. 
-	for (uint i=0; i<number_of_nodes; ++i) {
-		result.push_back( station_t(i + 1) );
+	if (search == "external") {
+		string work_dir = get_option(argc, argv, "work-dir", filename + ".external");
+		size_t sort_memory = static_cast<size_t>(stod(get_option(argc, argv, "sort-memory", 
+			to_string(ExternalSearch::DEFAULT_SORT_MEMORY / (1024 * 1024)))) * 1024 * 1024);
+		mkdir(work_dir.c_str(), 0755);
+		ExternalSearch* external = new ExternalSearch( &problem.graph, problem.schools, 
+			problem.stations, problem.bus, heuristic, filename, work_dir, sort_memory );
+		external->set_resume( has_option(argc, argv, "resume") );
+		return unique_ptr<SearchEngine>( external );
 	}
 
-	for (string station: stations) {
-		// First we need to separate the station name from
-		// the individual passengers and their destinations.
-		vector<string> statID;
-		vector<string> passengers;
-		// Separate the stationID
-		split_string(station, statID, ':'); 
-		// Separate the passengers. 
-		split_string(statID[1], passengers, ',');
-		// Get the station ID. A vector of only one element.
-		vector<uint> stat_id; 
-		extract_alphanumerics_in_order(statID[0], stat_id);
-		// Now generate a vector of passengers. 
-		vector<passenger_t> p;
-		for (string passenger: passengers) {
-			vector<uint> passenger_values;
-			extract_alphanumerics_in_order(passenger, passenger_values);
-			// The first value is the number of passengers wanting 
-			// to go to a given destination. 
-			
-			// The second value is the ID of the school, we need the ID 
-			// of that school's station.
-			int destination_station = 
-				findSchoolStationOnList( passenger_values[1], schools );
-			// The origin is the station ID.
-			for (uint i=0; i < passenger_values[0]; ++i) {
-				p.push_back( 
-					passenger_t( 
-						stat_id[0], 
-						static_cast<uint>(destination_station)
-						) 
-				);
-			}
-		}
+	if (search == "frontier")
+		return unique_ptr<SearchEngine>( new FrontierSearch( &problem.graph, problem.schools, 
+			problem.stations, problem.bus, heuristic, filename) );
+
+	if (search == "lazy")
+		return unique_ptr<SearchEngine>( new LazySearch( &problem.graph, problem.schools, 
+			problem.stations, problem.bus, heuristic, filename) );
+
+	if (search == "ida") {
+		DepthFirstSearch* ida = new DepthFirstSearch( &problem.graph, problem.schools, 
+			problem.stations, problem.bus, heuristic, filename);
+		size_t table = static_cast<size_t>(stod(get_option(argc, argv, "tt-mb", "64")) * 1024 * 1024);
+		ida->set_transposition_table( table, 
+			TranspositionTable::replacement_from_name(get_option(argc, argv, "tt-replace", "depth")) );
+		return unique_ptr<SearchEngine>( ida );
+	}
 
-		// Push parsed passengers into the station on the result.
-		for (passenger_t pas : p)
-			result[stat_id[0]-1]._passengers.push_back(pas);
+	if (search == "pida") {
+		uint threads = stoul(get_option(argc, argv, "threads", 
+			to_string(thread::hardware_concurrency())));
+		ParallelDepthFirstSearch* pida = new ParallelDepthFirstSearch( &problem.graph, problem.schools, 
+			problem.stations, problem.bus, heuristic, filename, threads);
+		pida->set_shared_closed( !has_option(argc, argv, "no-shared-closed") );
+		return unique_ptr<SearchEngine>( pida );
 	}
 
-	// Now we need to insert 
-}
+	if (search == "epea")
+		return unique_ptr<SearchEngine>( new EPEASearch( &problem.graph, problem.schools, 
+			problem.stations, problem.bus, heuristic, filename) );
 
-void parse_bus(char *argv[], uint number_of_nodes, bus_t& bus) 
-{
-		// Input file is the first argument, 
-	ifstream infile(argv[1]);
+	return nullptr;
+}
 
-	// Read up to the part where the bus features are listed. 
-	string line;
-	for (uint i=0; i<= number_of_nodes+2; ++i) 
-		getline(infile, line);
-	
-	getline(infile, line);
-	vector<string> bus_features;
-	split_string(line, bus_features, ':');
-	vector<uint> features;
-	extract_alphanumerics_in_order(bus_features[1], features);
-	bus._origin_station = features[0];
-	bus._max_passengers = features[1];
-	bus._current_station = features[0];
-}	
 
 /**
 	INPUT
@@ -310,13 +251,20 @@ int main (int argc, char* argv[])
 
 	#ifdef TESTING 
 	test_graph();
-	test_string_split();
+	test_parser();
 	#endif 
 
+	if (has_option(argc, argv, "batch"))
+		return run_batch(argc, argv);
+
+	if (has_option(argc, argv, "serve"))
+		return run_service(argc, argv);
+
 	// If no arguments are given then there is 
 	// nothing to do here, 
-	if (argc < 2) {
-		cout << "Usage: bus-routing <problem.prob> <heuristic>" << endl;
+	vector<string> args = get_positional(argc, argv);
+	if (args.empty()) {
+		print_usage();
 		exit(0);
 	}
 
@@ -331,22 +279,24 @@ int main (int argc, char* argv[])
 		- We need to feed this information to the initial node in 
 		order to kickstart the search problem. 
 	 */
-	Graph graph = generate_graph(argv); 
+	problem_t problem;
+	try {
+		problem = parse_problem_file( args[0] );
+	}
+	catch ( const exception& e ) {
+		cerr << "Cannot parse " << args[0] << ": " << e.what() << endl;
+		exit(1);
+	}
+	Graph& graph = problem.graph;
 	#ifdef TESTING
 	graph.print();
 	#endif
-	vector<school_t> schools;
-	parse_schools( argv, graph.getVectorCount(), schools);
-	
-	vector<station_t> stations;
-	parse_stations( argv, graph.getVectorCount(), stations, schools);
-
-	//sort(stations.begin(), stations.end(), less<station_t>() );
-
-	bus_t bus;
-	parse_bus( argv, graph.getVectorCount(), bus );
 	
 	#ifdef TESTING
+	vector<school_t>& schools = problem.schools;
+	vector<station_t>& stations = problem.stations;
+	bus_t& bus = problem.bus;
+
 	// print schools.
 	cout << "Schools: " << endl;
 	for (school_t sc : schools) {
@@ -367,33 +317,58 @@ int main (int argc, char* argv[])
 	// print bus stats. 
 	cout << "Bus: P" << bus._origin_station << " " << bus._max_passengers << endl;
 
-	state_t initial(&graph, stations, bus, string("none"));
+	state_t initial(&graph, stations, bus, heuristic_t::NONE);
 	test_state_type( initial );
 	//#endif
 	#else 
 	/* Step 2. Decide the list of heuristics to apply. */
-	string heuristic;
-	if (argc > 2) {
-		if (MAX_DIST_PASSENGER_H.compare(argv[2]) == 0)
-			heuristic = MAX_DIST_PASSENGER_H;
-
-		if (MAX_DIST_STATION_H.compare(argv[2]) == 0)
-			heuristic = MAX_DIST_STATION_H;
-
-		if (ALL_H.compare(argv[2]) == 0)
-			heuristic = ALL_H;
-	}	
-	else
-		heuristic = "none";
+	heuristic_t heuristic = parse_heuristic( args.size() > 1 ? args[1] : "none" );
 
 	/* Step 3. Solve the search problem. */
+	graph.precomputeShortestPaths();
+	if (!graph.hasPrecomputedShortestPaths() && has_option(argc, argv, "hierarchy")) {
+		auto start = chrono::steady_clock::now();
+		graph.precomputeContractionHierarchy();
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		cout << "Map too large for a distance table, built a contraction hierarchy in " 
+			<< elapsed.count() << " s" << endl;
+	}
+	else if (!graph.hasPrecomputedShortestPaths()) {
+		size_t landmarks = stoul(get_option(argc, argv, "landmarks", to_string(Graph::DEFAULT_LANDMARKS)));
+		graph.precomputeLandmarks(landmarks);
+		cout << "Map too large for a distance table, using " << graph.getLandmarkCount() 
+			<< " landmarks" << endl;
+	}
+	unique_ptr<SearchEngine> solver;
+	try {
+		solver = make_search(argc, argv, problem, heuristic, args[0]);
+	}
+	catch ( const exception& e ) {
+		cerr << e.what() << endl;
+		exit(1);
+	}
+	if (!solver) {
+		cerr << "Unknown search '" << get_option(argc, argv, "search", "") << "'" << endl;
+		print_usage();
+		exit(1);
+	}
 	cout << "Launching solver..." << endl;
-	Solver solver( &graph, schools, stations, bus, heuristic, argv[1]); 
-	if (solver.solve()) {
-		/* Step 4. Write down the '.output' and '.statistics' files. */
-		solver.write_stats_file();
-		solver.write_down_solution_file();
+	running_search = solver.get();
+	signal(SIGINT, stop_search);
+	signal(SIGTERM, stop_search);
+	try {
+		if (solver->solve()) {
+			/* Step 4. Write down the '.output' and '.statistics' files. */
+			solver->write_stats_file();
+			solver->write_down_solution_file();
+		}
 	}
+	catch ( const exception& e ) {
+		cerr << e.what() << endl;
+		exit(1);
+	}
+	if (has_option(argc, argv, "json-stats"))
+		solver->write_json_stats_file();
 	#endif
 	// End.
 }
@@ -433,45 +408,45 @@ void test_state_type( state_t& initialized )
 }	
 
 
-void test_string_split() 
+void test_parser() 
 {
-	string str1 = "P1 P2 P3 P4 P5 ";
-	string str2 = " P1 P2 P3 P4 P5\n";
-	string str3 = "P1: 1 C2, 2 C3; P4: 1 C3; P5: 1 C2";
-	string str4 = "C1: P6; C2: P3; C3: P8";
-	vector<string> v1 {}, v2 {}, v3 {}, v4{};
-
-	split_string(str1, v1, ' ');
-	split_string(str2, v2, ' ');
-	split_string(str3, v3, ';');
-	split_string(str4, v4, ';');
+	string text = 
+		"   P1 P2 P3 P4\n"
+		"P1 -- 2  3  19\n"
+		"P2 2  -- 1  9 \n"
+		"P3 3  1  -- --\r\n"
+		"P4 1  9  -- --\n"
+		"C1: P3; C2: P4;\n"
+		"P1: 1 C2, 2 C1; P2: 1 C1\n"
+		"B: P2 3\n";
+
+	problem_t problem = parse_problem( text );
 
 	// Basic catchs. 
-	assert (v1.size() == 5);
-	assert (v2.size() == 5);
-	assert (v3.size() == 3);
-	assert (v4.size() == 3);
-
-	// Print results for visual validation. 
-	cout << "Printing vector 1: ";
-	for (string str: v1) 
-		cout << " '" << str << "' ";
-	cout << endl << endl;
-
-	cout << "Printing vector 2: ";
-	for (string str: v2) 
-		cout << " '" << str << "' ";
-	cout << endl << endl;
-	
-	cout << "Printing vector 3: ";
-	for (string str: v3) 
-		cout << " '" << str << "' ";
-	cout << endl;
+	assert (problem.graph.getVectorCount() == 4);
+	assert (problem.graph.getCost(1, 3) == 3);
+	assert (problem.graph.getCost(3, 2) == 1);
+	assert (problem.schools.size() == 2);
+	assert (problem.schools[1]._station_id == 4);
+	assert (problem.stations.size() == 4);
+	assert (problem.stations[0]._passengers.size() == 3);
+	assert (problem.stations[0]._passengers[0]._destination_id == 4);
+	assert (problem.stations[0]._passengers[2]._destination_id == 3);
+	assert (problem.stations[1]._passengers.size() == 1);
+	assert (problem.bus._origin_station == 2);
+	assert (problem.bus._max_passengers == 3);
+
+	bool rejected = false;
+	try {
+		parse_problem( "P1 P2\nP1 -- 1\n" );
+	}
+	catch ( const exception& e ) {
+		rejected = true;
+	}
+	assert (rejected);
+	(void) rejected;
 
-	cout << "Printing vector 4: ";
-	for (string str: v4) 
-		cout << " '" << str << "' ";
-	cout << endl;
+	cout << "All tests for the parser have been passed. " << endl;
 }
 
 /*
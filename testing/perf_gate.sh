@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Performance regression gate.
+#
+# Solves a fixed set of instances with bench-solver and compares time, 
+# peak RSS and expansions against perf_baseline.csv with bench-compare. 
+# Exits non-zero if anything got slower, bigger or lost its solution.
+#
+#   ./perf_gate.sh            compare against the baseline
+#   ./perf_gate.sh --update   record a new baseline
+#
+# Tolerances are relative and can be overridden from the environment:
+# TIME_TOLERANCE (0.25), RSS_TOLERANCE (0.15), EXPANSION_TOLERANCE (0) 
+# and MIN_TIME_DELTA (0.05 seconds). The baseline is machine dependent, 
+# record it again with --update when the gate moves to another machine.
+
+repetitions=${REPETITIONS:-3};
+baseline="perf_baseline.csv";
+problems="input_one_school.probl,input_two_origins.probl";
+heuristics="none,all";
+
+cd "$(dirname "$0")"
+
+# Build the benchmark tools.
+mkdir -p ../build
+cd ../build
+(cmake .. && make bench-solver bench-compare) > /dev/null || exit 2
+cd ../testing
+
+results=$(mktemp -d)
+trap 'rm -rf $results' EXIT
+
+echo "Running the gate instances."
+../build/bench-solver --problems=$problems --heuristics=$heuristics \
+    --repetitions=$repetitions --csv=$results/problems.csv > /dev/null || exit 2
+../build/bench-solver --stations=6,8 --schools=1,2 --passengers=2 --seeds=1,2 \
+    --heuristics=$heuristics --repetitions=$repetitions --csv=$results/generated.csv > /dev/null || exit 2
+cat $results/problems.csv > $results/current.csv
+tail -n +2 $results/generated.csv >> $results/current.csv
+
+if [ "$1" == "--update" ]; then
+    cp $results/current.csv $baseline
+    echo "Baseline written to $baseline."
+    exit 0
+fi
+
+../build/bench-compare $baseline $results/current.csv \
+    --time-tolerance=${TIME_TOLERANCE:-0.25} \
+    --rss-tolerance=${RSS_TOLERANCE:-0.15} \
+    --expansion-tolerance=${EXPANSION_TOLERANCE:-0} \
+    --min-time-delta=${MIN_TIME_DELTA:-0.05}